@@ -12,8 +12,10 @@
 #include "ns3/internet-module.h"
 #include "ns3/network-module.h"
 #include "ns3/point-to-point-module.h"
+#include "ns3/stats-module.h"
 #include "ns3/traffic-control-module.h"
 
+#include <fstream>
 #include <iostream>
 
 using namespace ns3;
@@ -23,9 +25,18 @@ Ptr<UniformRandomVariable> uv = CreateObject<UniformRandomVariable>();
 std::string dir = "rack/example/";
 double stopTime = 10;
 
+// Binary trace writers, used instead of the .plotme files with --binaryTraces
+Ptr<BinaryTraceWriter> cwndWriter;
+Ptr<BinaryTraceWriter> rttWriter;
+
 static void
 CwndChange(uint32_t oldCwnd, uint32_t newCwnd)
 {
+    if (cwndWriter)
+    {
+        cwndWriter->Write({newCwnd / 524.0});
+        return;
+    }
     std::ofstream fPlotQueue(dir + "Traces/cwnd.plotme", std::ios::out | std::ios::app);
     fPlotQueue << Simulator::Now().GetSeconds() << " " << newCwnd / 524.0 << std::endl;
     fPlotQueue.close();
@@ -40,9 +51,18 @@ TraceCwnd(uint32_t node, uint32_t cwndWindow, Callback<void, uint32_t, uint32_t>
                                   CwndTrace);
 }
 
+// RTT distribution of the flow, written as a mergeable sketch at the end of the run
+QuantileSketch rttSketch;
+
 static void
 RttChange(Time oldRtt, Time newRtt)
 {
+    rttSketch.AddTime(newRtt);
+    if (rttWriter)
+    {
+        rttWriter->Write({newRtt.GetSeconds()});
+        return;
+    }
     std::ofstream fPlotQueue(dir + "Traces/rtt.plotme", std::ios::out | std::ios::app);
     fPlotQueue << Simulator::Now().GetSeconds() << " " << newRtt.GetSeconds() << std::endl;
     fPlotQueue.close();
@@ -65,8 +85,14 @@ main(int argc, char* argv[])
     uint32_t delAckCount = 1;
     bool dsack = false;
     bool rack = false;
+    bool tlp = false;
+    bool adaptiveReoWnd = false;
+    bool undo = false;
+    bool tso = false;
     bool reorder = false;
     bool dupack = true;
+    bool binaryTraces = false;
+    std::string reorderModel = "PATTERN";
     std::string tcpTypeId = "ns3::TcpLinuxReno";
     time_t rawtime;
     struct tm* timeinfo;
@@ -92,12 +118,36 @@ main(int argc, char* argv[])
                  stopTime);
     cmd.AddValue("dsack", "Enable/Disable DSACK mode", dsack);
     cmd.AddValue("rack", "Enable/Disable RACK mode", rack);
+    cmd.AddValue("tlp", "Enable/Disable TLP mode", tlp);
+    cmd.AddValue("adaptiveReoWnd",
+                 "Set the RACK reordering window from the measured reordering",
+                 adaptiveReoWnd);
+    cmd.AddValue("undo", "Undo the window reductions proven spurious", undo);
+    cmd.AddValue("tso", "Send super-segments, split by the point-to-point devices", tso);
     cmd.AddValue("reorder", "Enable/Disable Rrordering of packets", reorder);
     cmd.AddValue("dupack", "Enable/Disable 3-DUPACK", dupack);
+    cmd.AddValue("reorderModel",
+                 "ReorderQueue offset model (PATTERN, RANDOM or TRACE); configure it further "
+                 "with --ns3::ReorderQueue<Packet>::<attribute>",
+                 reorderModel);
+    cmd.AddValue("binaryTraces",
+                 "Write cwnd and RTT as compressed binary traces (convert them with "
+                 "binary-trace-to-plotme)",
+                 binaryTraces);
     cmd.Parse(argc, argv);
 
     uv->SetStream(stream);
 
+    if (binaryTraces)
+    {
+        cwndWriter = Create<BinaryTraceWriter>(dir + "Traces/cwnd.btrace",
+                                               std::vector<std::string>{"cwnd"},
+                                               true);
+        rttWriter = Create<BinaryTraceWriter>(dir + "Traces/rtt.btrace",
+                                              std::vector<std::string>{"rtt"},
+                                              true);
+    }
+
     // Create nodes
     NodeContainer senders, routers, receivers;
     routers.Create(2);
@@ -109,7 +159,7 @@ main(int argc, char* argv[])
 
     if (reorder)
     {
-        p2p.SetQueue("ns3::ReorderQueue");
+        p2p.SetQueue("ns3::ReorderQueue", "Model", StringValue(reorderModel));
     }
     p2p.SetDeviceAttribute("DataRate", StringValue("1Mbps"));
     p2p.SetChannelAttribute("Delay", StringValue("10ms"));
@@ -165,6 +215,10 @@ main(int argc, char* argv[])
     Config::SetDefault("ns3::TcpSocket::SegmentSize", UintegerValue(dataSize));
     Config::SetDefault("ns3::TcpSocketBase::Dsack", BooleanValue(dsack));
     Config::SetDefault("ns3::TcpSocketBase::Rack", BooleanValue(rack));
+    Config::SetDefault("ns3::TcpSocketBase::Tlp", BooleanValue(tlp));
+    Config::SetDefault("ns3::TcpRack::AdaptiveReoWnd", BooleanValue(adaptiveReoWnd));
+    Config::SetDefault("ns3::TcpSocketBase::Undo", BooleanValue(undo));
+    Config::SetDefault("ns3::TcpSocketBase::Tso", BooleanValue(tso));
     Config::SetDefault("ns3::TcpSocketBase::Sack", BooleanValue(true));
     Config::SetDefault("ns3::FifoQueueDisc::MaxSize", QueueSizeValue(QueueSize("50p")));
     Config::SetDefault("ns3::TcpSocketBase::WindowScaling", BooleanValue(true));
@@ -207,6 +261,14 @@ main(int argc, char* argv[])
 
     Simulator::Stop(Seconds(stopTime));
     Simulator::Run();
+    // Flush the binary traces
+    cwndWriter = nullptr;
+    rttWriter = nullptr;
+
+    std::ofstream sketchFile(dir + "Traces/rtt.sketch");
+    rttSketch.SerializeToCsv(sketchFile);
+    std::ofstream cdfFile(dir + "Traces/rtt-cdf.plotme");
+    rttSketch.SerializeCdf(cdfFile);
 
     Simulator::Destroy();
     return 0;
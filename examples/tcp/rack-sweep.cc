@@ -0,0 +1,294 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Batch driver for the RACK experiments.
+//
+// Runs every combination of a seed list and a parameter grid of a TCP
+// scenario program (rack-example by default, or e.g. scratch/web-traffic)
+// as independent child processes, keeping up to --jobs of them running at
+// once. ns-3 keeps a single simulator per process, so replications are
+// isolated by process rather than by thread.
+//
+// Each replication runs in its own working directory
+//
+//   <outputDir>/rack<r>-dsack<d>-tlp<t>-reorder<o>-delack<k>/rng<seed>/
+//
+// so the relative output paths used by the scenarios (rack/example/...,
+// rack/http/...) never collide. The scenario's stdout and stderr are
+// captured in run.log in the same directory.
+//
+// A grid axis left empty is not forwarded to the scenario, which keeps its
+// own default. For example, the sweep previously done by http.sh is
+//
+//   ./ns3 run "rack-sweep --scenario=build/scratch/ns3-dev-web-traffic-debug
+//              --seeds=1,3,5,7,10 --rack=false,true --dsack=true"
+//
+// and the one done by results.sh is
+//
+//   ./ns3 run "rack-sweep --rack=false,true --dsack=true --reorder=false,true
+//              --extraArgs=--stopTime=10"
+
+#include "ns3/core-module.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <tuple>
+#include <unistd.h>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("RackSweep");
+
+/// One replication: the working directory and the scenario arguments.
+struct Run
+{
+    std::string dir;               //!< Working directory of the replication
+    std::vector<std::string> args; //!< Scenario arguments, without argv[0]
+};
+
+/**
+ * Split a comma separated list.
+ *
+ * @param list The list
+ * @return The non-empty elements of the list
+ */
+static std::vector<std::string>
+SplitList(const std::string& list)
+{
+    std::vector<std::string> out;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ','))
+    {
+        if (!item.empty())
+        {
+            out.push_back(item);
+        }
+    }
+    return out;
+}
+
+/**
+ * Build the cartesian product of the seed list and the parameter grid.
+ *
+ * @param outputDir Root of the per-run output directories
+ * @param seeds RngRun values
+ * @param grid Ordered (scenario option, directory tag, values) axes
+ * @param extraArgs Arguments passed unchanged to every replication
+ * @return The replications
+ */
+static std::vector<Run>
+ExpandGrid(const std::string& outputDir,
+           const std::vector<std::string>& seeds,
+           const std::vector<std::tuple<std::string, std::string, std::vector<std::string>>>& grid,
+           const std::vector<std::string>& extraArgs)
+{
+    std::vector<Run> points{Run{"", extraArgs}};
+    for (const auto& [option, tag, values] : grid)
+    {
+        if (values.empty())
+        {
+            continue;
+        }
+        std::vector<Run> next;
+        for (const auto& point : points)
+        {
+            for (const auto& value : values)
+            {
+                Run r = point;
+                r.dir += (r.dir.empty() ? "" : "-") + tag + value;
+                r.args.push_back("--" + option + "=" + value);
+                next.push_back(r);
+            }
+        }
+        points = next;
+    }
+
+    std::vector<Run> runs;
+    for (const auto& point : points)
+    {
+        for (const auto& seed : seeds)
+        {
+            Run r = point;
+            r.dir = SystemPath::Append(outputDir,
+                                       SystemPath::Append(r.dir.empty() ? "default" : r.dir,
+                                                          "rng" + seed));
+            r.args.push_back("--RngRun=" + seed);
+            runs.push_back(r);
+        }
+    }
+    return runs;
+}
+
+/**
+ * Start one replication in a child process.
+ *
+ * @param program Absolute path of the scenario program
+ * @param run The replication
+ * @return The child pid, or -1 if the process could not be created
+ */
+static pid_t
+Launch(const std::string& program, const Run& run)
+{
+    SystemPath::MakeDirectories(run.dir);
+
+    std::vector<char*> argv;
+    argv.push_back(const_cast<char*>(program.c_str()));
+    for (const auto& arg : run.args)
+    {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+    std::string log = SystemPath::Append(run.dir, "run.log");
+
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        // Only async-signal-safe calls from here on.
+        int fd = open(log.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0 || chdir(run.dir.c_str()) != 0)
+        {
+            _exit(127);
+        }
+        dup2(fd, STDOUT_FILENO);
+        dup2(fd, STDERR_FILENO);
+        close(fd);
+        execv(program.c_str(), argv.data());
+        _exit(127);
+    }
+    return pid;
+}
+
+int
+main(int argc, char* argv[])
+{
+    std::string scenario;
+    std::string outputDir = "rack/sweep";
+    std::string seeds = "1,3,5,7,10,12,15,18,21,28,35,43,50,70,120,200,800,1200,3000,5000,7000,"
+                        "13000,17000,25000,30000";
+    std::string rack = "false,true";
+    std::string dsack;
+    std::string tlp;
+    std::string reorder;
+    std::string delAckCount;
+    std::string extraArgs;
+    uint32_t jobs = std::thread::hardware_concurrency();
+    bool dryRun = false;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("scenario",
+                 "Scenario program to run (default: rack-example next to this binary)",
+                 scenario);
+    cmd.AddValue("outputDir", "Root directory of the per-run output directories", outputDir);
+    cmd.AddValue("seeds", "Comma separated RngRun values", seeds);
+    cmd.AddValue("rack", "Comma separated values of --rack", rack);
+    cmd.AddValue("dsack", "Comma separated values of --dsack", dsack);
+    cmd.AddValue("tlp", "Comma separated values of --tlp", tlp);
+    cmd.AddValue("reorder", "Comma separated values of --reorder", reorder);
+    cmd.AddValue("delAckCount", "Comma separated values of --delAckCount", delAckCount);
+    cmd.AddValue("extraArgs", "Comma separated arguments passed to every run", extraArgs);
+    cmd.AddValue("jobs", "Number of runs executed in parallel (default: all cores)", jobs);
+    cmd.AddValue("dryRun", "Only print the runs", dryRun);
+    cmd.Parse(argc, argv);
+
+    if (scenario.empty())
+    {
+        // Binaries in a directory share the ns3-<version>-...-<profile> naming.
+        std::string self = SystemPath::Split(argv[0]).back();
+        auto pos = self.find("rack-sweep");
+        NS_ABORT_MSG_IF(pos == std::string::npos, "Cannot derive the scenario name from " << self);
+        scenario = SystemPath::Append(SystemPath::FindSelfDirectory(),
+                                      self.replace(pos, std::strlen("rack-sweep"), "rack-example"));
+    }
+    char* resolved = realpath(scenario.c_str(), nullptr);
+    NS_ABORT_MSG_IF(resolved == nullptr, "Scenario " << scenario << " not found");
+    std::string program(resolved);
+    free(resolved);
+
+    char* cwd = getcwd(nullptr, 0);
+    if (outputDir.empty() || outputDir[0] != '/')
+    {
+        outputDir = SystemPath::Append(cwd, outputDir);
+    }
+    free(cwd);
+
+    std::vector<Run> runs = ExpandGrid(outputDir,
+                                       SplitList(seeds),
+                                       {{"rack", "rack", SplitList(rack)},
+                                        {"dsack", "dsack", SplitList(dsack)},
+                                        {"tlp", "tlp", SplitList(tlp)},
+                                        {"reorder", "reorder", SplitList(reorder)},
+                                        {"delAckCount", "delack", SplitList(delAckCount)}},
+                                       SplitList(extraArgs));
+    jobs = std::max<uint32_t>(jobs, 1);
+
+    std::cout << runs.size() << " runs of " << program << " on " << jobs << " jobs" << std::endl;
+    if (dryRun)
+    {
+        for (const auto& run : runs)
+        {
+            std::cout << run.dir << ":";
+            for (const auto& arg : run.args)
+            {
+                std::cout << " " << arg;
+            }
+            std::cout << std::endl;
+        }
+        return 0;
+    }
+
+    std::map<pid_t, const Run*> active;
+    std::size_t next = 0;
+    std::size_t failed = 0;
+    while (next < runs.size() || !active.empty())
+    {
+        while (next < runs.size() && active.size() < jobs)
+        {
+            const Run& run = runs[next++];
+            pid_t pid = Launch(program, run);
+            if (pid < 0)
+            {
+                std::cerr << "fork failed for " << run.dir << ": " << std::strerror(errno)
+                          << std::endl;
+                ++failed;
+                continue;
+            }
+            active[pid] = &run;
+        }
+        if (active.empty())
+        {
+            continue;
+        }
+
+        int status;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0)
+        {
+            NS_ABORT_MSG_IF(errno != EINTR, "waitpid failed: " << std::strerror(errno));
+            continue;
+        }
+        auto it = active.find(pid);
+        if (it == active.end())
+        {
+            continue;
+        }
+        bool ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        failed += ok ? 0 : 1;
+        std::cout << (ok ? "done   " : "FAILED ") << it->second->dir << std::endl;
+        active.erase(it);
+    }
+
+    std::cout << runs.size() - failed << "/" << runs.size() << " runs succeeded" << std::endl;
+    return failed == 0 ? 0 : 1;
+}
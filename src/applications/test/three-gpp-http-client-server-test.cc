@@ -20,6 +20,7 @@
 #include "ns3/nstime.h"
 #include "ns3/packet.h"
 #include "ns3/ptr.h"
+#include "ns3/quantile-sketch.h"
 #include "ns3/simple-channel.h"
 #include "ns3/simple-net-device.h"
 #include "ns3/tcp-congestion-ops.h"
@@ -307,6 +308,8 @@ class ThreeGppHttpObjectTestCase : public TestCase
     Ptr<MinMaxAvgTotalCalculator<double>> m_delayCalculator;
     /// Keeps statistical information of round-trip delays (in seconds).
     Ptr<MinMaxAvgTotalCalculator<double>> m_rttCalculator;
+    /// Distribution of the round-trip delays, connected directly to `RxRtt`.
+    QuantileSketch m_rttSketch;
 
 }; // end of `class HttpClientServerTestCase`
 
@@ -562,6 +565,10 @@ ThreeGppHttpObjectTestCase::DoRun()
         "RxRtt",
         MakeCallback(&ThreeGppHttpObjectTestCase::ClientRxRttCallback, this));
     NS_ASSERT(traceSourceConnected);
+    traceSourceConnected = httpClient->TraceConnectWithoutContext(
+        "RxRtt",
+        MakeCallback(&QuantileSketch::TraceSinkDelayAddress, &m_rttSketch));
+    NS_ASSERT(traceSourceConnected);
 
     Simulator::Schedule(Seconds(1), &ThreeGppHttpObjectTestCase::ProgressCallback, this);
 
@@ -590,6 +597,15 @@ ThreeGppHttpObjectTestCase::DoRun()
 
     // Some post-simulation tests.
     NS_TEST_EXPECT_MSG_EQ(m_numOfPagesReceived, 3, "Unexpected number of web pages processed.");
+    NS_TEST_EXPECT_MSG_EQ(m_rttSketch.GetCount(),
+                          static_cast<uint64_t>(m_rttCalculator->getCount()),
+                          "The sketch missed round-trip delays.");
+    NS_TEST_EXPECT_MSG_EQ(m_rttSketch.GetMin(),
+                          m_rttCalculator->getMin(),
+                          "Unexpected minimum round-trip delay in the sketch.");
+    NS_TEST_EXPECT_MSG_EQ(m_rttSketch.GetMax(),
+                          m_rttCalculator->getMax(),
+                          "Unexpected maximum round-trip delay in the sketch.");
     NS_TEST_EXPECT_MSG_EQ(m_requestObjectTracker.IsEmpty(),
                           true,
                           "Tracker of request objects detected irrelevant packet(s).");
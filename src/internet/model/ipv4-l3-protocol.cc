@@ -16,6 +16,8 @@
 #include "ipv4-raw-socket-impl.h"
 #include "ipv4-route.h"
 #include "loopback-net-device.h"
+#include "tcp-header.h"
+#include "tcp-l4-protocol.h"
 
 #include "ns3/boolean.h"
 #include "ns3/callback.h"
@@ -25,6 +27,7 @@
 #include "ns3/node.h"
 #include "ns3/object-vector.h"
 #include "ns3/packet.h"
+#include "ns3/segmentation-offload.h"
 #include "ns3/socket.h"
 #include "ns3/string.h"
 #include "ns3/trace-source-accessor.h"
@@ -124,6 +127,7 @@ Ipv4L3Protocol::Ipv4L3Protocol()
     m_mcb = MakeCallback(&Ipv4L3Protocol::IpMulticastForward, this);
     m_lcb = MakeCallback(&Ipv4L3Protocol::LocalDeliver, this);
     m_ecb = MakeCallback(&Ipv4L3Protocol::RouteInputError, this);
+    SegmentationOffload::Register(PROT_NUMBER, MakeCallback(&Ipv4L3Protocol::SegmentWirePacket));
 }
 
 Ipv4L3Protocol::~Ipv4L3Protocol()
@@ -978,7 +982,27 @@ Ipv4L3Protocol::SendRealOut(Ptr<Ipv4Route> route, Ptr<Packet> packet, const Ipv4
     if (outInterface->IsUp())
     {
         NS_LOG_LOGIC("Send to " << targetLabel << " " << target);
-        if (packet->GetSize() + ipHeader.GetSerializedSize() > outInterface->GetDevice()->GetMtu())
+        GsoTag gsoTag;
+        if (packet->PeekPacketTag(gsoTag))
+        {
+            // A super-segment is split by the device if it can, here otherwise
+            if (outInterface->GetDevice()->SupportsSegmentationOffload())
+            {
+                CallTxTrace(ipHeader, packet, this, interface);
+                outInterface->Send(packet, ipHeader, target);
+                return;
+            }
+            packet->RemovePacketTag(gsoTag);
+            for (const auto& segment :
+                 DoSegmentation(packet, ipHeader, gsoTag.GetSegmentSize()))
+            {
+                NS_LOG_LOGIC("Sending segment " << *(segment.first));
+                CallTxTrace(segment.second, segment.first, this, interface);
+                outInterface->Send(segment.first, segment.second, target);
+            }
+        }
+        else if (packet->GetSize() + ipHeader.GetSerializedSize() >
+                 outInterface->GetDevice()->GetMtu())
         {
             std::list<Ipv4PayloadHeaderPair> listFragments;
             DoFragmentation(packet, ipHeader, outInterface->GetDevice()->GetMtu(), listFragments);
@@ -1523,6 +1547,76 @@ Ipv4L3Protocol::DoFragmentation(Ptr<Packet> packet,
     } while (moreFragment);
 }
 
+std::list<Ipv4L3Protocol::Ipv4PayloadHeaderPair>
+Ipv4L3Protocol::DoSegmentation(Ptr<Packet> packet,
+                               const Ipv4Header& ipv4Header,
+                               uint16_t segmentSize)
+{
+    NS_LOG_FUNCTION(packet << ipv4Header << segmentSize);
+    NS_ASSERT_MSG(ipv4Header.GetProtocol() == TcpL4Protocol::PROT_NUMBER,
+                  "Only TCP super-segments are supported");
+    NS_ASSERT(segmentSize > 0);
+
+    Ptr<Packet> p = packet->Copy();
+    TcpHeader tcpHeader;
+    p->RemoveHeader(tcpHeader);
+    Ipv4Header segmentIpv4Header = ipv4Header;
+    if (Node::ChecksumEnabled())
+    {
+        // The checksum state is not carried by the serialized headers
+        tcpHeader.EnableChecksums();
+        tcpHeader.InitializeChecksum(ipv4Header.GetSource(),
+                                     ipv4Header.GetDestination(),
+                                     TcpL4Protocol::PROT_NUMBER);
+        segmentIpv4Header.EnableChecksum();
+    }
+
+    std::list<Ipv4PayloadHeaderPair> segments;
+    uint32_t payloadSize = p->GetSize();
+    uint16_t identification = ipv4Header.GetIdentification();
+    for (uint32_t offset = 0; offset < payloadSize || segments.empty(); offset += segmentSize)
+    {
+        uint32_t size = std::min<uint32_t>(segmentSize, payloadSize - offset);
+        bool isLast = offset + size == payloadSize;
+
+        Ptr<Packet> segment = p->CreateFragment(offset, size);
+        TcpHeader segmentTcpHeader = tcpHeader;
+        segmentTcpHeader.SetSequenceNumber(tcpHeader.GetSequenceNumber() + offset);
+        uint8_t flags = tcpHeader.GetFlags();
+        if (!isLast)
+        {
+            flags &= ~(TcpHeader::FIN | TcpHeader::PSH);
+        }
+        if (offset > 0)
+        {
+            flags &= ~TcpHeader::CWR;
+        }
+        segmentTcpHeader.SetFlags(flags);
+        segment->AddHeader(segmentTcpHeader);
+
+        segmentIpv4Header.SetPayloadSize(segment->GetSize());
+        segmentIpv4Header.SetIdentification(identification++);
+        segments.emplace_back(segment, segmentIpv4Header);
+    }
+    return segments;
+}
+
+std::list<Ptr<Packet>>
+Ipv4L3Protocol::SegmentWirePacket(Ptr<Packet> packet, uint16_t segmentSize)
+{
+    NS_LOG_FUNCTION(packet << segmentSize);
+    Ipv4Header ipv4Header;
+    packet->RemoveHeader(ipv4Header);
+
+    std::list<Ptr<Packet>> wirePackets;
+    for (auto& segment : DoSegmentation(packet, ipv4Header, segmentSize))
+    {
+        segment.first->AddHeader(segment.second);
+        wirePackets.push_back(segment.first);
+    }
+    return wirePackets;
+}
+
 bool
 Ipv4L3Protocol::ProcessFragment(Ptr<Packet>& packet, Ipv4Header& ipHeader, uint32_t iif)
 {
@@ -413,6 +413,31 @@ class Ipv4L3Protocol : public Ipv4
                          uint32_t outIfaceMtu,
                          std::list<Ipv4PayloadHeaderPair>& listFragments);
 
+    /**
+     * @brief Split a TCP super-segment into segments
+     *
+     * Every segment gets a copy of the TCP header, with its sequence number
+     * advanced and FIN, PSH and CWR only where they apply, and of the IPv4
+     * header, with its payload size and identification adjusted.
+     *
+     * @param packet the TCP header and payload of the super-segment
+     * @param ipv4Header the IPv4 header of the super-segment
+     * @param segmentSize the payload size of the segments
+     * @return the segments, in sequence order
+     */
+    static std::list<Ipv4PayloadHeaderPair> DoSegmentation(Ptr<Packet> packet,
+                                                           const Ipv4Header& ipv4Header,
+                                                           uint16_t segmentSize);
+
+    /**
+     * @brief Split a TCP super-segment into wire packets, for the
+     *        NetDevices supporting segmentation offload
+     * @param packet the super-segment, starting with its IPv4 header
+     * @param segmentSize the payload size of the segments
+     * @return the wire packets, starting with their IPv4 header
+     */
+    static std::list<Ptr<Packet>> SegmentWirePacket(Ptr<Packet> packet, uint16_t segmentSize);
+
     /**
      * @brief Process a packet fragment
      * @param packet the packet
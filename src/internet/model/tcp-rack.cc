@@ -9,7 +9,14 @@
 
 #include "tcp-rack.h"
 
+#include "ns3/boolean.h"
+#include "ns3/double.h"
 #include "ns3/log.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 namespace ns3
 {
@@ -17,13 +24,60 @@ namespace ns3
 NS_LOG_COMPONENT_DEFINE("TcpRack");
 NS_OBJECT_ENSURE_REGISTERED(TcpRack);
 
+namespace
+{
+
+/**
+ * @brief Nearest-rank percentile of a set of samples
+ * @param samples the samples, not empty
+ * @param percentile the percentile, in [0, 1]
+ * @return the sample at the given percentile
+ */
+template <typename T>
+T
+Percentile(const std::deque<T>& samples, double percentile)
+{
+    std::vector<T> sorted(samples.begin(), samples.end());
+    auto rank = static_cast<std::size_t>(std::ceil(percentile * sorted.size()));
+    auto nth = sorted.begin() + (rank > 0 ? rank - 1 : 0);
+    std::nth_element(sorted.begin(), nth, sorted.end());
+    return *nth;
+}
+
+} // namespace
+
 TypeId
 TcpRack::GetTypeId()
 {
     static TypeId tid = TypeId("ns3::TcpRack")
                             .SetParent<Object>()
                             .AddConstructor<TcpRack>()
-                            .SetGroupName("Internet");
+                            .SetGroupName("Internet")
+                            .AddAttribute("AdaptiveReoWnd",
+                                          "Set RACK.reo_wnd from a percentile of the measured "
+                                          "reordering extents instead of min_RTT/4 steps",
+                                          BooleanValue(false),
+                                          MakeBooleanAccessor(&TcpRack::m_adaptive),
+                                          MakeBooleanChecker())
+                            .AddAttribute("ReoWndPercentile",
+                                          "Percentile of the reordering extents used as "
+                                          "RACK.reo_wnd in adaptive mode",
+                                          DoubleValue(0.95),
+                                          MakeDoubleAccessor(&TcpRack::m_percentile),
+                                          MakeDoubleChecker<double>(0, 1))
+                            .AddAttribute("ReorderHistory",
+                                          "Number of reordering samples kept",
+                                          UintegerValue(64),
+                                          MakeUintegerAccessor(&TcpRack::m_reorderHistory),
+                                          MakeUintegerChecker<uint32_t>(1))
+                            .AddTraceSource("ReoWnd",
+                                            "RACK reordering window",
+                                            MakeTraceSourceAccessor(&TcpRack::m_reoWnd),
+                                            "ns3::TracedValueCallback::Time")
+                            .AddTraceSource("ReorderSample",
+                                            "Reordering extent of a segment delivered out of order",
+                                            MakeTraceSourceAccessor(&TcpRack::m_reorderSampleTrace),
+                                            "ns3::TcpRack::ReorderSampleTracedCallback");
     return tid;
 }
 
@@ -39,7 +93,9 @@ TcpRack::TcpRack()
       m_reoWndIncr(1),
       m_reoWndPersist(16),
       m_srtt(0),
-      m_alpha(0.125)
+      m_adaptive(false),
+      m_percentile(0.95),
+      m_reorderHistory(64)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -56,7 +112,11 @@ TcpRack::TcpRack(const TcpRack& other)
       m_reoWndIncr(other.m_reoWndIncr),
       m_reoWndPersist(other.m_reoWndPersist),
       m_srtt(other.m_srtt),
-      m_alpha(other.m_alpha)
+      m_adaptive(other.m_adaptive),
+      m_percentile(other.m_percentile),
+      m_reorderHistory(other.m_reorderHistory),
+      m_extents(other.m_extents),
+      m_degrees(other.m_degrees)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -103,29 +163,53 @@ TcpRack::UpdateStats(uint32_t tser,
         m_rttSeq = sndNxt;
     }
 
-    if (m_minRtt.IsZero())
-    {
-        m_minRtt = m_rackRtt;
-    }
-    else
+    if (SentAfter(xmitTs, m_rackXmitTs, endSeq.GetValue(), m_rackEndSeq.GetValue()))
     {
-        m_minRtt = std::min(m_minRtt, m_rackRtt);
+        m_rackXmitTs = xmitTs;
+        m_rackEndSeq = endSeq;
     }
+}
 
-    if (m_srtt == 0)
-    {
-        m_srtt = m_rackRtt.GetMilliSeconds();
-    }
-    else
+void
+TcpRack::UpdateRtt(const TcpRttSample& sample)
+{
+    NS_LOG_FUNCTION(this);
+
+    if (!sample.rtt.IsZero())
     {
-        m_srtt = (1 - m_alpha) * m_srtt + m_alpha * m_rackRtt.GetMilliSeconds();
+        m_srtt = sample.srtt;
+        m_minRtt = sample.minRtt;
     }
+}
 
-    if (SentAfter(xmitTs, m_rackXmitTs, endSeq.GetValue(), m_rackEndSeq.GetValue()))
+void
+TcpRack::SampleReordering(Time xmitTs, uint32_t segments)
+{
+    NS_LOG_FUNCTION(this << xmitTs << segments);
+
+    Time extent = Max(Simulator::Now() - xmitTs - m_rackRtt, Time(0));
+    NS_LOG_DEBUG("Reordering of " << segments << " segments, " << extent.As(Time::MS));
+
+    m_extents.push_back(extent);
+    m_degrees.push_back(segments);
+    while (m_extents.size() > m_reorderHistory)
     {
-        m_rackXmitTs = xmitTs;
-        m_rackEndSeq = endSeq;
+        m_extents.pop_front();
+        m_degrees.pop_front();
     }
+    m_reorderSampleTrace(extent, segments);
+}
+
+Time
+TcpRack::GetReorderExtent() const
+{
+    return m_extents.empty() ? Time(0) : Percentile(m_extents, m_percentile);
+}
+
+uint32_t
+TcpRack::GetReorderDegree() const
+{
+    return m_degrees.empty() ? 0 : Percentile(m_degrees, m_percentile);
 }
 
 void
@@ -164,20 +248,29 @@ TcpRack::UpdateReoWnd(bool reorderSeen,
         if (m_reoWndPersist <= 0)
         {
             m_reoWndIncr = 1;
+            m_extents.clear();
+            m_degrees.clear();
         }
     }
 
+    // Adaptive mode: the measured extent, plus one min_RTT/4 step per
+    // DSACK round for the spurious retransmissions it did not prevent
+    if (m_adaptive && !m_extents.empty())
+    {
+        m_reoWnd = Min(GetReorderExtent() + (m_minRtt / 4) * (m_reoWndIncr - 1), m_srtt);
+        return;
+    }
+
     if (!reorderSeen)
     {
         if ((tcb->m_congState >= TcpSocketState::CA_RECOVERY) || (sacked >= dupAckThresh))
         {
-            m_reoWnd = 0;
+            m_reoWnd = Time(0);
             return;
         }
     }
 
-    m_reoWnd = (m_minRtt / 4).GetSeconds() * m_reoWndIncr;
-    m_reoWnd = std::min(m_reoWnd, m_srtt);
+    m_reoWnd = Min((m_minRtt / 4) * m_reoWndIncr, m_srtt);
 }
 
 } // namespace ns3
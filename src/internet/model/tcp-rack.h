@@ -10,6 +10,7 @@
 #pragma once
 
 #include "tcp-option-sack.h"
+#include "tcp-rtt-sampler.h"
 #include "tcp-socket-state.h"
 
 #include "ns3/nstime.h"
@@ -17,8 +18,11 @@
 #include "ns3/packet.h"
 #include "ns3/sequence-number.h"
 #include "ns3/simulator.h"
+#include "ns3/traced-callback.h"
 #include "ns3/traced-value.h"
 
+#include <deque>
+
 namespace ns3
 {
 
@@ -86,7 +90,7 @@ class TcpRack : public Object
      * @param xmitTs transmission timestamp of the packet
      * @param endSeq end sequence number of the packet
      * @param sndNxt SND.NXT when the RTT is updated
-     * @param lastRtt estimated round trip time
+     * @param lastRtt RTT of the most recently sent (S)ACKed packet
      */
     virtual void UpdateStats(uint32_t tser,
                              bool retrans,
@@ -95,11 +99,55 @@ class TcpRack : public Object
                              SequenceNumber32 sndNxt,
                              Time lastRtt);
 
+    /**
+     * @brief Takes srtt and min_rtt from the RTT sampler of the connection
+     *
+     * @param sample the RTT information after the last ACK
+     */
+    void UpdateRtt(const TcpRttSample& sample);
+
+    /**
+     * @brief Records the reordering extent of a segment delivered out of order
+     *
+     * Called for every never retransmitted segment that is (S)ACKed after a
+     * segment sent later than it. The extent in time is how much longer
+     * than RACK.rtt the segment took to be delivered, i.e. the reordering
+     * window that would have been needed not to mark it lost. The last
+     * ReorderHistory samples are kept; with AdaptiveReoWnd, RACK.reo_wnd is
+     * set from the ReoWndPercentile of the time extents.
+     *
+     * @param xmitTs transmission timestamp of the segment
+     * @param segments number of segments sent after it that were delivered first
+     */
+    void SampleReordering(Time xmitTs, uint32_t segments);
+
+    /**
+     * @brief returns the ReoWndPercentile of the measured reordering extents in time
+     *
+     * Zero if no reordering has been measured.
+     */
+    Time GetReorderExtent() const;
+
+    /**
+     * @brief returns the ReoWndPercentile of the measured reordering extents in segments
+     *
+     * Zero if no reordering has been measured.
+     */
+    uint32_t GetReorderDegree() const;
+
+    /**
+     * @brief TracedCallback signature for reordering samples.
+     *
+     * @param [in] extent Reordering extent in time.
+     * @param [in] segments Reordering extent in segments.
+     */
+    typedef void (*ReorderSampleTracedCallback)(Time extent, uint32_t segments);
+
     /**
      * @brief returns Reordering Window
      *
      */
-    double GetReoWnd() const
+    Time GetReoWnd() const
     {
         return m_reoWnd;
     }
@@ -136,14 +184,21 @@ class TcpRack : public Object
     Time m_rackXmitTs{0};             //!< Latest transmission timestamp of Rack.packet
     SequenceNumber32 m_rackEndSeq{0}; //!< Ending sequence number of Rack.packet
     Time m_rackRtt{0};  //!< RTT of the most recently transmitted packet that has been acknowledged
-    double m_reoWnd{0}; //!< Re-ordering Window
-    Time m_minRtt{0};   //!< Minimum RTT
+    TracedValue<Time> m_reoWnd{Time(0)}; //!< Re-ordering Window
+    Time m_minRtt{0};   //!< Windowed minimum RTT, from the RTT sampler
     SequenceNumber32 m_rttSeq{0}; //!< SND.NXT when RACK.rtt is updated
     bool m_dsack{false}; //!< If a DSACK option has been received since last RACK.reo_wnd change
     uint32_t m_reoWndIncr{1};     //!< Multiplier applied to adjust RACK.reo_wnd
     uint32_t m_reoWndPersist{16}; //!< Number of loss recoveries before resetting RACK.reo_wnd
-    double m_srtt{0};             //!< Smoothened RTT (SRTT) as specified in [RFC6298]
-    double m_alpha{0.125};        //!< EWMA constant for calculation of SRTT (alpha = 1/8)
+    Time m_srtt{0};               //!< Smoothed RTT (SRTT), from the RTT sampler
+
+    bool m_adaptive{false};         //!< Set RACK.reo_wnd from the measured reordering
+    double m_percentile{0.95};      //!< Percentile of the extents used for RACK.reo_wnd
+    uint32_t m_reorderHistory{64};  //!< Number of reordering samples kept
+    std::deque<Time> m_extents;     //!< Last reordering extents in time
+    std::deque<uint32_t> m_degrees; //!< Last reordering extents in segments
+
+    TracedCallback<Time, uint32_t> m_reorderSampleTrace; //!< Reordering samples
 };
 } // namespace ns3
 
@@ -0,0 +1,130 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "tcp-rtt-sampler.h"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("TcpRttSampler");
+NS_OBJECT_ENSURE_REGISTERED(TcpRttSampler);
+
+TypeId
+TcpRttSampler::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::TcpRttSampler")
+                            .SetParent<Object>()
+                            .SetGroupName("Internet")
+                            .AddConstructor<TcpRttSampler>()
+                            .AddAttribute("MinRttWindow",
+                                          "Window of the min_rtt filter",
+                                          TimeValue(Seconds(300)),
+                                          MakeTimeAccessor(&TcpRttSampler::SetMinRttWindow),
+                                          MakeTimeChecker(Time(1)));
+    return tid;
+}
+
+TcpRttSampler::TcpRttSampler()
+    : Object(),
+      m_minRttWindow(Seconds(300)),
+      m_minRttFilter(m_minRttWindow.GetTimeStep(), 0, 0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TcpRttSampler::TcpRttSampler(const TcpRttSampler& other)
+    : Object(other),
+      m_minRttWindow(other.m_minRttWindow),
+      m_minRttFilter(other.m_minRttFilter),
+      m_sample(other.m_sample)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+TcpRttSampler::SetMinRttWindow(Time window)
+{
+    NS_LOG_FUNCTION(this << window);
+    m_minRttWindow = window;
+    m_minRttFilter.SetWindowLength(window.GetTimeStep());
+}
+
+void
+TcpRttSampler::SetEstimator(Ptr<RttEstimator> estimator)
+{
+    NS_LOG_FUNCTION(this << estimator);
+    m_estimator = estimator;
+}
+
+Ptr<RttEstimator>
+TcpRttSampler::GetEstimator() const
+{
+    return m_estimator;
+}
+
+void
+TcpRttSampler::Subscribe(SampleCallback cb)
+{
+    NS_LOG_FUNCTION(this);
+    m_subscribers.push_back(cb);
+}
+
+void
+TcpRttSampler::AddSample(Time rtt, Time latestRtt)
+{
+    NS_LOG_FUNCTION(this << rtt << latestRtt);
+
+    if (rtt.IsZero() && latestRtt.IsZero())
+    {
+        return;
+    }
+
+    m_sample.rtt = rtt;
+    if (!latestRtt.IsZero())
+    {
+        m_sample.latestRtt = latestRtt;
+    }
+
+    if (!rtt.IsZero())
+    {
+        NS_ASSERT_MSG(m_estimator, "No RTT estimator set");
+        m_estimator->Measurement(rtt);
+        m_sample.srtt = m_estimator->GetEstimate();
+        m_sample.rttVar = m_estimator->GetVariation();
+
+        m_minRttFilter.Update(rtt.GetTimeStep(), Simulator::Now().GetTimeStep());
+        m_sample.minRtt = TimeStep(m_minRttFilter.GetBest());
+    }
+
+    NS_LOG_DEBUG("srtt " << m_sample.srtt << " rttvar " << m_sample.rttVar << " min_rtt "
+                         << m_sample.minRtt << " latest " << m_sample.latestRtt);
+
+    for (const auto& cb : m_subscribers)
+    {
+        cb(m_sample);
+    }
+}
+
+const TcpRttSample&
+TcpRttSampler::GetSample() const
+{
+    return m_sample;
+}
+
+void
+TcpRttSampler::Reset()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_estimator)
+    {
+        m_estimator->Reset();
+    }
+    m_minRttFilter.Reset(0, 0);
+    m_sample = TcpRttSample();
+}
+
+} // namespace ns3
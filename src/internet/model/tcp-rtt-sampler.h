@@ -0,0 +1,133 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef TCP_RTT_SAMPLER_H
+#define TCP_RTT_SAMPLER_H
+
+#include "rtt-estimator.h"
+#include "windowed-filter.h"
+
+#include "ns3/callback.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @ingroup tcp
+ *
+ * @brief The RTT information of a connection after an ACK
+ */
+struct TcpRttSample
+{
+    Time rtt{0};       //!< RTT sample of this ACK, zero if none (Karn's algorithm)
+    Time latestRtt{0}; //!< RTT of the most recently sent segment delivered so far
+    Time srtt{0};      //!< Smoothed RTT, as specified in [RFC6298]
+    Time rttVar{0};    //!< RTT variation, as specified in [RFC6298]
+    Time minRtt{0};    //!< Minimum RTT over the last MinRttWindow, zero if none
+};
+
+/**
+ * @ingroup tcp
+ *
+ * @brief Per-connection RTT sampling service
+ *
+ * The socket feeds the sampler once per ACK; the sampler updates the
+ * RttEstimator (srtt and rttvar, hence the RTO), a windowed minimum of the
+ * RTT samples and the RTT of the most recently sent delivered segment, and
+ * hands the resulting TcpRttSample to its subscribers. RACK, TLP and the
+ * congestion control all read the same values, instead of each of them
+ * smoothing its own copy of the estimate.
+ */
+class TcpRttSampler : public Object
+{
+  public:
+    /**
+     * @brief Get the type ID.
+     * @return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    TcpRttSampler();
+
+    /**
+     * @brief Copy constructor
+     *
+     * Neither the subscribers nor the estimator are copied: they are bound
+     * to the objects of the original connection, and the copy is left
+     * without an estimator until SetEstimator is called.
+     *
+     * @param other the object to copy
+     */
+    TcpRttSampler(const TcpRttSampler& other);
+
+    /**
+     * @brief Callback invoked with the RTT information after every sample
+     */
+    typedef Callback<void, const TcpRttSample&> SampleCallback;
+
+    /**
+     * @brief Set the estimator that computes srtt and rttvar
+     * @param estimator the RTT estimator
+     */
+    void SetEstimator(Ptr<RttEstimator> estimator);
+
+    /**
+     * @brief Get the estimator that computes srtt and rttvar
+     * @return the RTT estimator
+     */
+    Ptr<RttEstimator> GetEstimator() const;
+
+    /**
+     * @brief Register a subscriber, called in registration order after
+     * every sample
+     * @param cb the subscriber
+     */
+    void Subscribe(SampleCallback cb);
+
+    /**
+     * @brief Process the RTT measured on an ACK
+     *
+     * Nothing happens if both values are zero.
+     *
+     * @param rtt the RTT sample, zero if the ACK gives no valid sample
+     * @param latestRtt the RTT of the most recently sent segment this ACK
+     *        delivers, zero if unknown
+     */
+    void AddSample(Time rtt, Time latestRtt);
+
+    /**
+     * @brief Get the current RTT information
+     * @return the values after the last sample
+     */
+    const TcpRttSample& GetSample() const;
+
+    /**
+     * @brief Forget the RTT information, including the estimator state
+     */
+    void Reset();
+
+  private:
+    /// Windowed minimum of the RTT samples, in time steps
+    typedef WindowedFilter<int64_t, MinFilter<int64_t>, int64_t, int64_t> MinRttFilter;
+
+    /**
+     * @brief Set the window of the min_rtt filter
+     * @param window the window length
+     */
+    void SetMinRttWindow(Time window);
+
+    Ptr<RttEstimator> m_estimator;             //!< Computes srtt and rttvar
+    Time m_minRttWindow;                       //!< Window of the min_rtt filter
+    MinRttFilter m_minRttFilter;               //!< Windowed min_rtt
+    TcpRttSample m_sample;                     //!< Values after the last sample
+    std::vector<SampleCallback> m_subscribers; //!< Notified after every sample
+};
+
+} // namespace ns3
+
+#endif /* TCP_RTT_SAMPLER_H */
@@ -33,6 +33,7 @@
 #include "tcp-option-winscale.h"
 #include "tcp-rate-ops.h"
 #include "tcp-recovery-ops.h"
+#include "tcp-rtt-sampler.h"
 #include "tcp-rx-buffer.h"
 #include "tcp-tlp.h"
 #include "tcp-tx-buffer.h"
@@ -47,6 +48,7 @@
 #include "ns3/object.h"
 #include "ns3/packet.h"
 #include "ns3/pointer.h"
+#include "ns3/segmentation-offload.h"
 #include "ns3/simulation-singleton.h"
 #include "ns3/simulator.h"
 #include "ns3/trace-source-accessor.h"
@@ -82,6 +84,12 @@ const std::map<std::pair<ns3::TcpSocketBase::TcpPacketType_t, ns3::TcpSocketStat
         {{ns3::TcpSocketBase::RE_XMT, ns3::TcpSocketState::DctcpEcn}, true},
         {{ns3::TcpSocketBase::DATA, ns3::TcpSocketState::DctcpEcn}, true},
     };
+
+/**
+ * @brief Largest payload of a super-segment: the IPv4 total length has 16 bits,
+ * and the IPv4 and TCP headers may take up to 80 bytes
+ */
+constexpr uint32_t MAX_TSO_SIZE = 65535 - 20 - 60;
 } // namespace
 
 namespace ns3
@@ -155,6 +163,34 @@ TcpSocketBase::GetTypeId()
                           BooleanValue(false),
                           MakeBooleanAccessor(&TcpSocketBase::m_rackEnabled),
                           MakeBooleanChecker())
+            .AddAttribute("Undo",
+                          "Undo the window reductions proven spurious by DSACK or timestamps",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&TcpSocketBase::m_undoEnabled),
+                          MakeBooleanChecker())
+            .AddAttribute("Tso",
+                          "Send new data as super-segments, split into segments by the "
+                          "device (TSO) or by the IP layer (GSO); IPv4 only",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&TcpSocketBase::m_tsoEnabled),
+                          MakeBooleanChecker())
+            .AddAttribute("TsoMaxSegments",
+                          "Maximum number of segments in a super-segment",
+                          UintegerValue(16),
+                          MakeUintegerAccessor(&TcpSocketBase::m_tsoMaxSegments),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("GroMaxSegments",
+                          "Maximum number of in-order segments merged into one receive "
+                          "aggregate, ACKed at once; 1 disables the aggregation",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&TcpSocketBase::m_groMaxSegments),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("GroFlushTimeout",
+                          "How long a receive aggregate waits for more segments; with 0, "
+                          "only the segments received at the same time are merged",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&TcpSocketBase::m_groFlushTimeout),
+                          MakeTimeChecker(Seconds(0)))
             .AddAttribute("Tlp",
                           "Enable or disable TLP option",
                           BooleanValue(false),
@@ -227,6 +263,15 @@ TcpSocketBase::GetTypeId()
                             "RTT of the last (S)ACKed packet",
                             MakeTraceSourceAccessor(&TcpSocketBase::m_lastRttTrace),
                             "ns3::TracedValueCallback::Time")
+            .AddTraceSource("RackTimer",
+                            "Expiration time of the RACK reordering timer, when (re)armed",
+                            MakeTraceSourceAccessor(&TcpSocketBase::m_rackTimerTrace),
+                            "ns3::Time::TracedCallback")
+            .AddTraceSource("Undo",
+                            "A spurious window reduction was undone, with the restored "
+                            "cWnd and ssThresh",
+                            MakeTraceSourceAccessor(&TcpSocketBase::m_undoTrace),
+                            "ns3::TcpSocketBase::UndoTracedCallback")
             .AddTraceSource("NextTxSequence",
                             "Next sequence number to send (SND.NXT)",
                             MakeTraceSourceAccessor(&TcpSocketBase::m_nextTxSequenceTrace),
@@ -328,6 +373,10 @@ TcpSocketBase::TcpSocketBase()
     m_tcb->m_rxBuffer = CreateObject<TcpRxBuffer>();
     m_rack = CreateObject<TcpRack>();
     m_tlp = CreateObject<TcpTlp>();
+    m_rttSampler = CreateObject<TcpRttSampler>();
+    m_rttSampler->Subscribe(MakeCallback(&TcpSocketBase::RttSampled, this));
+    m_rttSampler->Subscribe(MakeCallback(&TcpRack::UpdateRtt, m_rack));
+    m_rttSampler->Subscribe(MakeCallback(&TcpTlp::UpdateRtt, m_tlp));
     m_sndFack = 0;
     m_retranData = 0;
 
@@ -390,6 +439,8 @@ TcpSocketBase::TcpSocketBase(const TcpSocketBase& sock)
       m_dupAckCount(sock.m_dupAckCount),
       m_delAckCount(0),
       m_delAckMaxCount(sock.m_delAckMaxCount),
+      m_groMaxSegments(sock.m_groMaxSegments),
+      m_groFlushTimeout(sock.m_groFlushTimeout),
       m_noDelay(sock.m_noDelay),
       m_synCount(sock.m_synCount),
       m_synRetries(sock.m_synRetries),
@@ -428,6 +479,9 @@ TcpSocketBase::TcpSocketBase(const TcpSocketBase& sock)
       m_dsackEnabled(sock.m_dsackEnabled),
       m_rackEnabled(sock.m_rackEnabled),
       m_tlpEnabled(sock.m_tlpEnabled),
+      m_undoEnabled(sock.m_undoEnabled),
+      m_tsoEnabled(sock.m_tsoEnabled),
+      m_tsoMaxSegments(sock.m_tsoMaxSegments),
       m_recover(sock.m_recover),
       m_recoverActive(sock.m_recoverActive),
       m_retxThresh(sock.m_retxThresh),
@@ -462,6 +516,11 @@ TcpSocketBase::TcpSocketBase(const TcpSocketBase& sock)
     m_tcb->m_rxBuffer = CopyObject(sock.m_tcb->m_rxBuffer);
     m_rack = CopyObject(sock.m_rack);
     m_tlp = CopyObject(sock.m_tlp);
+    m_rttSampler = CopyObject(sock.m_rttSampler);
+    m_rttSampler->SetEstimator(m_rtt);
+    m_rttSampler->Subscribe(MakeCallback(&TcpSocketBase::RttSampled, this));
+    m_rttSampler->Subscribe(MakeCallback(&TcpRack::UpdateRtt, m_rack));
+    m_rttSampler->Subscribe(MakeCallback(&TcpTlp::UpdateRtt, m_tlp));
 
     m_tcb->m_pacingRate = m_tcb->m_maxPacingRate;
     m_pacingTimer.SetFunction(&TcpSocketBase::NotifyPacingPerformed, this);
@@ -483,6 +542,7 @@ TcpSocketBase::TcpSocketBase(const TcpSocketBase& sock)
         m_tcb->m_sendEmptyPacketCallback = MakeCallback(&TcpSocketBase::SendEmptyPacket, this);
     }
     m_sndFack = sock.m_sndFack;
+    m_priorFack = sock.m_priorFack;
     m_retranData = sock.m_retranData;
 
     bool ok;
@@ -580,6 +640,13 @@ void
 TcpSocketBase::SetRtt(Ptr<RttEstimator> rtt)
 {
     m_rtt = rtt;
+    m_rttSampler->SetEstimator(rtt);
+}
+
+Ptr<TcpRttSampler>
+TcpSocketBase::GetRttSampler() const
+{
+    return m_rttSampler;
 }
 
 /* Inherit from Socket class: Returns error code */
@@ -810,7 +877,7 @@ TcpSocketBase::Connect(const Address& address)
     }
 
     // Re-initialize parameters in case this socket is being reused after CLOSE
-    m_rtt->Reset();
+    m_rttSampler->Reset();
     m_synCount = m_synRetries;
     m_dataRetrCount = m_dataRetries;
 
@@ -1267,6 +1334,8 @@ TcpSocketBase::ForwardUp(Ptr<Packet> packet,
     if (header.GetEcn() == Ipv4Header::ECN_CE && m_ecnCESeq < tcpHeader.GetSequenceNumber())
     {
         NS_LOG_INFO("Received CE flag is valid");
+        // The pending receive aggregate was not CE marked: ACK it without ECE
+        GroFlush();
         NS_LOG_DEBUG(TcpSocketState::EcnStateName[m_tcb->m_ecnState] << " -> ECN_CE_RCVD");
         m_ecnCESeq = tcpHeader.GetSequenceNumber();
         m_tcb->m_ecnState = TcpSocketState::ECN_CE_RCVD;
@@ -1307,6 +1376,8 @@ TcpSocketBase::ForwardUp6(Ptr<Packet> packet,
     if (header.GetEcn() == Ipv6Header::ECN_CE && m_ecnCESeq < tcpHeader.GetSequenceNumber())
     {
         NS_LOG_INFO("Received CE flag is valid");
+        // The pending receive aggregate was not CE marked: ACK it without ECE
+        GroFlush();
         NS_LOG_DEBUG(TcpSocketState::EcnStateName[m_tcb->m_ecnState] << " -> ECN_CE_RCVD");
         m_ecnCESeq = tcpHeader.GetSequenceNumber();
         m_tcb->m_ecnState = TcpSocketState::ECN_CE_RCVD;
@@ -1398,6 +1469,14 @@ TcpSocketBase::DoForwardUp(Ptr<Packet> packet, const Address& fromAddress, const
     packet->RemoveHeader(tcpHeader);
     SequenceNumber32 seq = tcpHeader.GetSequenceNumber();
 
+    // A segment that does not continue the pending receive aggregate must
+    // find the aggregate in the Rx buffer before its options are processed:
+    // its TSval is recorded only if it starts at RCV.NXT
+    if (m_groPacket && !GroCanMerge(packet, tcpHeader))
+    {
+        GroFlush();
+    }
+
     if (m_state == ESTABLISHED && !(tcpHeader.GetFlags() & TcpHeader::RST))
     {
         // Check if the sender has responded to ECN echo by reducing the Congestion Window
@@ -1681,15 +1760,56 @@ TcpSocketBase::ReadOptions(const TcpHeader& tcpHeader, uint32_t* bytesSacked)
         // Check only for ACK options here
         switch (option->GetKind())
         {
-        case TcpOption::SACK:
-            *bytesSacked = ProcessOptionSack(option);
+        case TcpOption::SACK: {
+            TcpOptionSack::SackList list = DynamicCast<const TcpOptionSack>(option)->GetSackList();
+            if (m_undoActive)
+            {
+                ProcessDsackUndo(list, tcpHeader.GetAckNumber());
+            }
+            *bytesSacked = ProcessOptionSack(list, tcpHeader.GetAckNumber());
             break;
+        }
         default:
             continue;
         }
     }
 }
 
+void
+TcpSocketBase::ProcessDsackUndo(const TcpOptionSack::SackList& list, SequenceNumber32 ackNumber)
+{
+    NS_LOG_FUNCTION(this << ackNumber);
+
+    if (list.empty())
+    {
+        return;
+    }
+
+    // A D-SACK (RFC 2883), i.e. a first block below the cumulative ACK of
+    // the segment or inside the second block, of data retransmitted since
+    // the window was reduced: that retransmission was not needed
+    auto first = list.begin();
+    auto second = std::next(first);
+    bool dsack = first->first < ackNumber ||
+                 (second != list.end() && first->first >= second->first &&
+                  first->second <= second->second);
+    if (dsack && m_undoRetrans > 0 && first->first >= m_undoMarker)
+    {
+        uint32_t duplicated = first->second - first->first;
+        auto segments =
+            static_cast<int32_t>((duplicated + m_tcb->m_segmentSize - 1) / m_tcb->m_segmentSize);
+        m_undoRetrans = std::max(m_undoRetrans - segments, 0);
+        NS_LOG_DEBUG("D-SACK of " << first->first << ":" << first->second << ", "
+                                  << m_undoRetrans << " retransmissions left to undo");
+        // Linux tcp_try_undo_dsack: the episode ended before the D-SACKs of
+        // all its retransmissions arrived
+        if (m_undoRetrans == 0 && m_tcb->m_congState <= TcpSocketState::CA_DISORDER)
+        {
+            UndoCwndReduction();
+        }
+    }
+}
+
 // Sender should reduce the Congestion Window as a response to receiver's
 // ECN Echo notification only once per window
 void
@@ -1727,6 +1847,11 @@ TcpSocketBase::EnterRecovery(uint32_t currentDelivered)
 
     NS_LOG_DEBUG(TcpSocketState::TcpCongStateName[m_tcb->m_congState] << " -> CA_RECOVERY");
 
+    if (m_undoEnabled)
+    {
+        InitUndo();
+    }
+
     if (!m_sackEnabled)
     {
         // One segment has left the network, PLUS the head is lost
@@ -1781,18 +1906,130 @@ void
 TcpSocketBase::RackLoss()
 {
     NS_LOG_FUNCTION(this);
-    double timeout = 0.0;
+    Time timeout{0};
     m_txBuffer->DetectRackLoss(m_rack, &timeout);
 
-    if (m_txBuffer->GetLost() != 0 && m_tcb->m_congState == TcpSocketState::CA_DISORDER)
+    // RFC 6675, Section 5.1: a new recovery phase must not start before
+    // HighACK reaches the RecoveryPoint of the previous one
+    if (m_txBuffer->GetLost() != 0 && m_tcb->m_congState < TcpSocketState::CA_RECOVERY &&
+        (m_highRxAckMark >= m_recover || !m_recoverActive))
     {
         EnterRecovery(m_tcb->m_lastAckedSackedBytes);
         NS_ASSERT(m_tcb->m_congState == TcpSocketState::CA_RECOVERY);
     }
 
-    if (timeout > 0)
+    // RFC 8985, Section 6.2, Step 5: a single timer covers all the segments
+    // still waiting for the reordering window; move it to the new deadline
+    m_rackTimer.Cancel();
+    if (timeout.IsStrictlyPositive())
+    {
+        m_rackTimer = Simulator::Schedule(timeout, &TcpSocketBase::RackTimeout, this);
+        m_rackTimerTrace(Simulator::Now() + timeout);
+    }
+}
+
+void
+TcpSocketBase::InitUndo()
+{
+    NS_LOG_FUNCTION(this);
+
+    m_priorCwnd = m_tcb->m_cWnd;
+    // Linux tcp_current_ssthresh (): in CA_CWR the reduction is already under way
+    if (m_tcb->m_congState == TcpSocketState::CA_CWR)
+    {
+        m_priorSsThresh = m_tcb->m_ssThresh;
+    }
+    else
+    {
+        m_priorSsThresh = std::max(m_tcb->m_ssThresh.Get(), m_tcb->m_cWnd.Get() / 4 * 3);
+    }
+    m_undoMarker = m_txBuffer->HeadSequence();
+    m_undoRetrans = -1;
+    m_retransStamp = 0;
+    m_undoActive = true;
+}
+
+bool
+TcpSocketBase::MayUndo() const
+{
+    if (!m_undoActive)
+    {
+        return false;
+    }
+    if (m_undoRetrans == 0)
+    {
+        return true;
+    }
+    return m_timestampEnabled && m_retransStamp != 0 && m_tcb->m_rcvTimestampEchoReply != 0 &&
+           m_tcb->m_rcvTimestampEchoReply < m_retransStamp;
+}
+
+void
+TcpSocketBase::UndoCwndReduction()
+{
+    NS_LOG_FUNCTION(this);
+
+    m_tcb->m_cWnd = std::max(m_tcb->m_cWnd.Get(), m_priorCwnd);
+    m_tcb->m_cWndInfl = m_tcb->m_cWnd;
+    if (m_priorSsThresh > m_tcb->m_ssThresh)
+    {
+        m_tcb->m_ssThresh = m_priorSsThresh;
+    }
+
+    // As in Linux tcp_undo_cwnd_reduction(), the segments marked lost were not
+    // lost after all
+    m_txBuffer->ClearLostMarks();
+
+    if (m_tcb->m_congState == TcpSocketState::CA_RECOVERY ||
+        m_tcb->m_congState == TcpSocketState::CA_LOSS)
     {
-        Simulator::Schedule(Seconds(timeout), &TcpSocketBase::RackLoss, this);
+        // Leave the episode as the ACK of m_recover would
+        NS_LOG_DEBUG(TcpSocketState::TcpCongStateName[m_tcb->m_congState] << " -> CA_OPEN");
+        if (m_tcb->m_congState == TcpSocketState::CA_RECOVERY)
+        {
+            m_recoveryOps->ExitRecovery(m_tcb);
+            m_tcb->m_cWndInfl = m_tcb->m_cWnd;
+        }
+        m_congestionControl->CongestionStateSet(m_tcb, TcpSocketState::CA_OPEN);
+        m_tcb->m_congState = TcpSocketState::CA_OPEN;
+        m_recoverActive = false;
+        m_dupAckCount = 0;
+        m_rackTimer.Cancel();
+    }
+    m_undoActive = false;
+
+    NS_LOG_INFO("Spurious reduction undone, cwnd " << m_tcb->m_cWnd << " ssthresh "
+                                                   << m_tcb->m_ssThresh);
+    m_undoTrace(m_tcb->m_cWnd, m_tcb->m_ssThresh);
+}
+
+void
+TcpSocketBase::RackTimeout()
+{
+    NS_LOG_FUNCTION(this);
+    RackLoss();
+    SendPendingData(m_connected);
+}
+
+void
+TcpSocketBase::SkbDelivered(TcpTxItem* item)
+{
+    NS_LOG_FUNCTION(this << item);
+    m_rateOps->SkbDelivered(item);
+
+    // A segment already SACKed was sampled when the SACK arrived; DiscardUpTo
+    // reports it again when it is cumulatively ACKed, after moving the head
+    bool alreadySampled = item->IsSacked() && item->GetStartSeq() < m_txBuffer->HeadSequence();
+    if (!m_rackEnabled || item->IsRetrans() || alreadySampled)
+    {
+        return;
+    }
+
+    SequenceNumber32 priorFack(m_priorFack);
+    if (item->GetStartSeq() < priorFack)
+    {
+        uint32_t segments = (priorFack - item->GetStartSeq() - 1) / m_tcb->m_segmentSize + 1;
+        m_rack->SampleReordering(item->GetLastSent(), segments);
     }
 }
 
@@ -1858,15 +2095,18 @@ TcpSocketBase::DupAck(uint32_t currentDelivered)
         // CA_RECOVERY and reducing sending rate again.
         NS_ASSERT((m_dupAckCount <= m_retxThresh) || m_recoverActive);
 
+        // With RACK, the loss detection runs on every ACK once the
+        // scoreboard is updated (see ReceivedAck) and replaces the
+        // DupThresh and FACK triggers below
+        if (m_rackEnabled)
+        {
+            return;
+        }
+
         // Check FACK recovery condition
         uint32_t fack_diff =
             std::max((int)0, ((int)m_sndFack) - ((int)(m_txBuffer->HeadSequence().GetValue())));
 
-        // Check for RACK losses
-        if (m_rackEnabled)
-        {
-            RackLoss();
-        }
         // RFC 6675, Section 5, continuing:
         // ... and take the following steps:
         // (1) If DupAcks >= DupThresh, go to step (4).
@@ -1878,9 +2118,9 @@ TcpSocketBase::DupAck(uint32_t currentDelivered)
         //     bandwidth-greedy application in high speed and reliable network
         //     (such as datacenter network) whose sending rate is constrained by
         //     TCP socket buffer size at receiver side.
-        else if ((m_fackEnabled && fack_diff > m_tcb->m_segmentSize * 3) ||
-                 ((m_dupAckCount == m_retxThresh) &&
-                  (m_highRxAckMark >= m_recover || !m_recoverActive)))
+        if ((m_fackEnabled && fack_diff > m_tcb->m_segmentSize * 3) ||
+            ((m_dupAckCount == m_retxThresh) &&
+             (m_highRxAckMark >= m_recover || !m_recoverActive)))
         {
             EnterRecovery(currentDelivered);
             NS_ASSERT(m_tcb->m_congState == TcpSocketState::CA_RECOVERY);
@@ -1931,6 +2171,7 @@ TcpSocketBase::ReceivedAck(Ptr<Packet> packet, const TcpHeader& tcpHeader)
     // scoreboard MUST be updated via the Update () routine (done in ReadOptions)
     uint32_t bytesSacked = 0;
     uint64_t previousDelivered = m_rateOps->GetConnectionRate().m_delivered;
+    m_priorFack = m_sndFack;
     ReadOptions(tcpHeader, &bytesSacked);
 
     SequenceNumber32 ackNumber = tcpHeader.GetAckNumber();
@@ -1967,7 +2208,7 @@ TcpSocketBase::ReceivedAck(Ptr<Packet> packet, const TcpHeader& tcpHeader)
             DynamicCast<const TcpOptionTS>(tcpHeader.GetOption(TcpOption::TS));
         uint32_t tser = ts->GetEcho();
         TcpTxItem item;
-        Time rtt = m_rtt->GetEstimate();
+        Time rtt = m_rttSampler->GetSample().latestRtt;
 
         // Get information of the latest packet (cumulatively)ACKed packet and update RACK
         // parameters
@@ -2008,12 +2249,12 @@ TcpSocketBase::ReceivedAck(Ptr<Packet> packet, const TcpHeader& tcpHeader)
                              m_tcb->m_nextTxSequence,
                              oldHeadSequence,
                              m_tcb,
-                             m_txBuffer->GetSacked(),
+                             m_txBuffer->GetSacked() / m_tcb->m_segmentSize,
                              m_retxThresh,
                              exiting);
     }
 
-    m_txBuffer->DiscardUpTo(ackNumber, MakeCallback(&TcpRateOps::SkbDelivered, m_rateOps));
+    m_txBuffer->DiscardUpTo(ackNumber, MakeCallback(&TcpSocketBase::SkbDelivered, this));
 
     auto currentDelivered =
         static_cast<uint32_t>(m_rateOps->GetConnectionRate().m_delivered - previousDelivered);
@@ -2065,6 +2306,15 @@ TcpSocketBase::ReceivedAck(Ptr<Packet> packet, const TcpHeader& tcpHeader)
     ProcessAck(ackNumber, (bytesSacked > 0), currentDelivered, oldHeadSequence, receivedData);
     m_tcb->m_isRetransDataAcked = false;
 
+    // RFC 8985, Section 6.2: detect losses after every scoreboard update, in
+    // every congestion state. Segments retransmitted in CA_RECOVERY or CA_LOSS
+    // and lost again are found here, and SendPendingData below retransmits
+    // them, instead of waiting for the RTO.
+    if (m_rackEnabled)
+    {
+        RackLoss();
+    }
+
     if (m_congestionControl->HasCongControl())
     {
         uint32_t currentLost = m_txBuffer->GetLost();
@@ -2212,6 +2462,16 @@ TcpSocketBase::ProcessAck(const SequenceNumber32& ackNumber,
         // (B.1) is done at the beginning, while (B.2) is delayed to part (C) while
         // trying to transmit with SendPendingData. We are not allowed to exit
         // the CA_RECOVERY phase. Just process this partial ack (RFC 5681)
+        // Spurious RTO or fast retransmit: the original transmissions were
+        // delivered, restore the window and continue in CA_OPEN (Linux
+        // tcp_try_undo_loss and tcp_try_undo_partial)
+        if ((m_tcb->m_congState == TcpSocketState::CA_LOSS ||
+             m_tcb->m_congState == TcpSocketState::CA_RECOVERY) &&
+            MayUndo())
+        {
+            UndoCwndReduction();
+        }
+
         if (ackNumber < m_recover && m_tcb->m_congState == TcpSocketState::CA_RECOVERY)
         {
             if (!m_sackEnabled)
@@ -2345,6 +2605,7 @@ TcpSocketBase::ProcessAck(const SequenceNumber32& ackNumber,
                 m_tcb->m_congState = TcpSocketState::CA_OPEN;
                 exitedFastRecovery = true;
                 m_dupAckCount = 0; // From recovery to open, reset dupack
+                m_rackTimer.Cancel();
 
                 NS_LOG_DEBUG(segsAcked << " segments acked in CA_RECOVER, ack of " << ackNumber
                                        << ", exiting CA_RECOVERY -> CA_OPEN");
@@ -2362,6 +2623,13 @@ TcpSocketBase::ProcessAck(const SequenceNumber32& ackNumber,
 
                 m_congestionControl->CongestionStateSet(m_tcb, TcpSocketState::CA_OPEN);
                 m_tcb->m_congState = TcpSocketState::CA_OPEN;
+                m_rackTimer.Cancel();
+                // Linux tcp_try_undo_recovery, at the end of the loss episode.
+                // Otherwise the D-SACKs still on their way may undo it later
+                if (MayUndo())
+                {
+                    UndoCwndReduction();
+                }
                 NS_LOG_DEBUG(segsAcked << " segments acked in CA_LOSS, ack of" << ackNumber
                                        << ", exiting CA_LOSS -> CA_OPEN");
             }
@@ -2379,6 +2647,11 @@ TcpSocketBase::ProcessAck(const SequenceNumber32& ackNumber,
                 NewAck(ackNumber, true);
                 m_tcb->m_cWnd = m_tcb->m_ssThresh.Get();
                 m_recoveryOps->ExitRecovery(m_tcb);
+                // Linux tcp_try_undo_recovery
+                if (MayUndo())
+                {
+                    UndoCwndReduction();
+                }
                 NS_LOG_DEBUG("Leaving Fast Recovery; BytesInFlight() = "
                              << BytesInFlight() << "; cWnd = " << m_tcb->m_cWnd);
             }
@@ -3331,12 +3604,29 @@ TcpSocketBase::SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withA
     NS_LOG_FUNCTION(this << seq << maxSize << withAck);
 
     bool isStartOfTransmission = BytesInFlight() == 0U;
-    TcpTxItem* outItem = m_txBuffer->CopyFromSequence(maxSize, seq);
+    // A super-segment (TSO) is sent as one packet, but it is tracked in the
+    // TxBuffer, and by the rate sampling, as full-sized segments
+    bool isSuperSegment = maxSize > m_tcb->m_segmentSize;
+    TcpTxItem* outItem =
+        m_txBuffer->CopyFromSequence(std::min(maxSize, m_tcb->m_segmentSize), seq);
 
     m_rateOps->SkbSent(outItem, isStartOfTransmission);
 
     bool isRetransmission = outItem->IsRetrans();
     Ptr<Packet> p = outItem->GetPacketCopy();
+    while (isSuperSegment && p->GetSize() < maxSize)
+    {
+        TcpTxItem* item =
+            m_txBuffer->CopyFromSequence(std::min(maxSize - p->GetSize(), m_tcb->m_segmentSize),
+                                         seq + SequenceNumber32(p->GetSize()));
+        if (item->GetSeqSize() == 0)
+        {
+            break;
+        }
+        NS_ASSERT_MSG(!item->IsRetrans(), "Super-segments carry new data only");
+        m_rateOps->SkbSent(item, false);
+        p->AddAtEnd(item->GetPacketCopy());
+    }
     uint32_t sz = p->GetSize(); // Size of packet
     uint8_t flags = withAck ? TcpHeader::ACK : 0;
     uint32_t remainingData = m_txBuffer->SizeFromSequence(seq + SequenceNumber32(sz));
@@ -3384,6 +3674,10 @@ TcpSocketBase::SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withA
 
     bool isEct = IsEct(isRetransmission ? TcpPacketType_t::RE_XMT : TcpPacketType_t::DATA);
     AddSocketTags(p, isEct);
+    if (sz > m_tcb->m_segmentSize)
+    {
+        p->AddPacketTag(GsoTag(m_tcb->m_segmentSize));
+    }
 
     if (m_closeOnEmpty && (remainingData == 0))
     {
@@ -3429,6 +3723,14 @@ TcpSocketBase::SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withA
     m_txTrace(p, header, this);
     if (isRetransmission)
     {
+        if (m_undoActive)
+        {
+            m_undoRetrans = std::max(m_undoRetrans, 0) + 1;
+            if (m_retransStamp == 0)
+            {
+                m_retransStamp = TcpOptionTS::NowToTsValue();
+            }
+        }
         if (m_endPoint)
         {
             m_retransmissionTrace(p,
@@ -3477,7 +3779,12 @@ TcpSocketBase::SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withA
     // send will also be cwnd limited if less then one segment of cwnd is available
     m_tcb->m_isCwndLimited = (m_tcb->m_cWnd < BytesInFlight() + m_tcb->m_segmentSize);
 
-    UpdateRttHistory(seq, sz, isRetransmission);
+    for (uint32_t offset = 0; offset < sz || offset == 0; offset += m_tcb->m_segmentSize)
+    {
+        UpdateRttHistory(seq + SequenceNumber32(offset),
+                         std::min(sz - offset, m_tcb->m_segmentSize),
+                         isRetransmission);
+    }
 
     // Update bytes sent during recovery phase
     if (m_tcb->m_congState == TcpSocketState::CA_RECOVERY ||
@@ -3669,6 +3976,23 @@ TcpSocketBase::SendPendingData(bool withAck, bool tlpRound)
             auto maxSizeToSend = static_cast<uint32_t>(nextHigh - next);
             s = std::min(s, maxSizeToSend);
 
+            // With TSO, new data goes out as a super-segment of whole segments,
+            // split into wire packets by the device or the IP layer. TLP probes
+            // and anything sent outside the Open state stay one segment long.
+            if (m_tsoEnabled && !tlpRound && m_endPoint != nullptr &&
+                m_tcb->m_congState == TcpSocketState::CA_OPEN &&
+                next == m_tcb->m_highTxMark.Get() && s == m_tcb->m_segmentSize)
+            {
+                auto rWndLeft = static_cast<uint32_t>(
+                    (m_highRxAckMark.Get() + SequenceNumber32(m_rWnd.Get())) - next);
+                uint32_t superSize = std::min({availableWindow,
+                                               availableData,
+                                               rWndLeft,
+                                               m_tsoMaxSegments * m_tcb->m_segmentSize,
+                                               MAX_TSO_SIZE});
+                s = std::max(s, superSize - superSize % m_tcb->m_segmentSize);
+            }
+
             // (C.2) If any of the data octets sent in (C.1) are below HighData,
             //       HighRxt MUST be set to the highest sequence number of the
             //       retransmitted segment unless NextSeg () rule (4) was
@@ -3701,7 +4025,7 @@ TcpSocketBase::SendPendingData(bool withAck, bool tlpRound)
                 m_sackEnabled && m_tcb->m_congState == TcpSocketState::CA_OPEN;
             if (m_tlpEnabled && checkConnectionState & !m_tlpRound)
             {
-                double rto_left = ((Simulator::GetDelayLeft(m_retxEvent).GetSeconds()));
+                Time rto_left = Simulator::GetDelayLeft(m_retxEvent);
                 // Schedule TLP timer
                 if (m_tlptimerEvent.IsPending())
                 {
@@ -3709,8 +4033,7 @@ TcpSocketBase::SendPendingData(bool withAck, bool tlpRound)
                     m_tlptimerEvent.Cancel();
                 }
                 uint32_t inflight = BytesInFlight();
-                Time rtt = m_rtt->GetEstimate();
-                Time m_pto = m_tlp->CalculatePto(rtt, inflight, (rto_left));
+                Time m_pto = m_tlp->CalculatePto(inflight, rto_left);
 
                 m_tlptimerEvent = Simulator::Schedule(m_pto, &TcpSocketBase::PTOTimeout, this);
             }
@@ -3865,10 +4188,115 @@ TcpSocketBase::ReceivedData(Ptr<Packet> p, const TcpHeader& tcpHeader)
     NS_LOG_DEBUG("Data segment, seq=" << tcpHeader.GetSequenceNumber()
                                       << " pkt size=" << p->GetSize());
 
+    if (m_groMaxSegments > 1)
+    {
+        GroReceive(p, tcpHeader);
+    }
+    else
+    {
+        ProcessReceivedData(p, tcpHeader, 1);
+    }
+}
+
+void
+TcpSocketBase::GroReceive(Ptr<Packet> p, const TcpHeader& tcpHeader)
+{
+    NS_LOG_FUNCTION(this << tcpHeader);
+
+    if (m_groPacket && GroCanMerge(p, tcpHeader))
+    {
+        m_groPacket->AddAtEnd(p);
+        m_groHeader.SetFlags(m_groHeader.GetFlags() | tcpHeader.GetFlags());
+        ++m_groSegments;
+        NS_LOG_LOGIC("Aggregated " << m_groSegments << " segments, " << m_groPacket->GetSize()
+                                   << " bytes");
+        if (m_groSegments >= m_groMaxSegments)
+        {
+            GroFlush();
+        }
+        return;
+    }
+    GroFlush();
+
+    // Only in-order data, with no hole in the Rx buffer, starts an aggregate
+    uint8_t flags = tcpHeader.GetFlags() & ~(TcpHeader::ACK | TcpHeader::PSH);
+    if (m_state == ESTABLISHED && flags == 0 && p->GetSize() > 0 &&
+        tcpHeader.GetSequenceNumber() == m_tcb->m_rxBuffer->NextRxSequence() &&
+        m_tcb->m_rxBuffer->Size() == m_tcb->m_rxBuffer->Available() &&
+        m_tcb->m_ecnState != TcpSocketState::ECN_CE_RCVD &&
+        m_tcb->m_ecnState != TcpSocketState::ECN_SENDING_ECE)
+    {
+        m_groPacket = p->Copy();
+        m_groHeader = tcpHeader;
+        m_groSegments = 1;
+        m_groFlushEvent =
+            Simulator::Schedule(m_groFlushTimeout, &TcpSocketBase::GroFlush, this);
+        return;
+    }
+    ProcessReceivedData(p, tcpHeader, 1);
+}
+
+bool
+TcpSocketBase::GroCanMerge(Ptr<const Packet> p, const TcpHeader& tcpHeader) const
+{
+    NS_ASSERT(m_groPacket);
+
+    uint8_t flags = tcpHeader.GetFlags() & ~(TcpHeader::ACK | TcpHeader::PSH);
+    if (flags != 0 || p->GetSize() == 0 || m_groSegments >= m_groMaxSegments ||
+        tcpHeader.GetSequenceNumber() !=
+            m_groHeader.GetSequenceNumber() + SequenceNumber32(m_groPacket->GetSize()) ||
+        tcpHeader.GetAckNumber() != m_groHeader.GetAckNumber() ||
+        m_tcb->m_ecnState == TcpSocketState::ECN_CE_RCVD ||
+        m_tcb->m_ecnState == TcpSocketState::ECN_SENDING_ECE)
+    {
+        return false;
+    }
+    // As in Linux, only segments with the same timestamp are merged, so
+    // that the ACK echoes the timestamp of every segment it covers
+    if (m_timestampEnabled)
+    {
+        auto ts = DynamicCast<const TcpOptionTS>(tcpHeader.GetOption(TcpOption::TS));
+        auto groTs = DynamicCast<const TcpOptionTS>(m_groHeader.GetOption(TcpOption::TS));
+        if (!ts || !groTs || ts->GetTimestamp() != groTs->GetTimestamp())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+TcpSocketBase::GroFlush()
+{
+    NS_LOG_FUNCTION(this);
+    m_groFlushEvent.Cancel();
+    if (!m_groPacket)
+    {
+        return;
+    }
+    Ptr<Packet> p = m_groPacket;
+    uint32_t segments = m_groSegments;
+    m_groPacket = nullptr;
+    m_groSegments = 0;
+    ProcessReceivedData(p, m_groHeader, segments);
+}
+
+void
+TcpSocketBase::ProcessReceivedData(Ptr<Packet> p, const TcpHeader& tcpHeader, uint32_t segments)
+{
+    NS_LOG_FUNCTION(this << tcpHeader << segments);
+
     // Put into Rx buffer
     SequenceNumber32 expectedSeq = m_tcb->m_rxBuffer->NextRxSequence();
     if (!m_tcb->m_rxBuffer->Add(p, tcpHeader))
     { // Insert failed: No data or RX buffer full
+        SequenceNumber32 seq = tcpHeader.GetSequenceNumber();
+        if (m_dsackEnabled && p->GetSize() > 0 && seq + p->GetSize() <= expectedSeq)
+        { // Duplicate ending at RCV.NXT, not out of range: report it as a D-SACK
+            m_isDsack = true;
+            m_dsackFirst = seq;
+            m_dsackSecond = seq + p->GetSize();
+        }
         if (m_tcb->m_ecnState == TcpSocketState::ECN_CE_RCVD ||
             m_tcb->m_ecnState == TcpSocketState::ECN_SENDING_ECE)
         {
@@ -3921,7 +4349,8 @@ TcpSocketBase::ReceivedData(Ptr<Packet> p, const TcpHeader& tcpHeader)
     }
     else
     { // In-sequence packet: ACK if delayed ack count allows
-        if (++m_delAckCount >= m_delAckMaxCount)
+        m_delAckCount += segments;
+        if (m_delAckCount >= m_delAckMaxCount)
         {
             m_delAckEvent.Cancel();
             m_delAckCount = 0;
@@ -4001,6 +4430,7 @@ TcpSocketBase::EstimateRtt(const TcpHeader& tcpHeader)
     NS_LOG_FUNCTION(this);
     SequenceNumber32 ackSeq = tcpHeader.GetAckNumber();
     Time rtt;
+    Time lastRtt;
 
     // An ack has been received, calculate rtt and log this measurement
     // Note we use a linear search (O(n)) for this since for the common
@@ -4029,23 +4459,32 @@ TcpSocketBase::EstimateRtt(const TcpHeader& tcpHeader)
         // In case of multiple packets being ACKed in a single acknowledgement, `m_lastRtt` is
         // RTT of the last (S)ACKed packet calculated using the data packet with the latest
         // transmission time
-        Time lastRtt = CalculateRttSample(tcpHeader, latestTransmittedPktHistory);
-        if (!lastRtt.IsZero())
-        {
-            NS_LOG_DEBUG("Last RTT sample updated to: " << lastRtt);
-            m_tcb->m_lastRtt = lastRtt;
-        }
+        lastRtt = CalculateRttSample(tcpHeader, latestTransmittedPktHistory);
+    }
+
+    // The sampler updates the estimator and notifies RACK, TLP and RttSampled()
+    m_rttSampler->AddSample(rtt, lastRtt);
+}
+
+void
+TcpSocketBase::RttSampled(const TcpRttSample& sample)
+{
+    NS_LOG_FUNCTION(this);
+
+    if (!sample.latestRtt.IsZero())
+    {
+        NS_LOG_DEBUG("Last RTT sample updated to: " << sample.latestRtt);
+        m_tcb->m_lastRtt = sample.latestRtt;
     }
 
-    if (!rtt.IsZero())
+    if (!sample.rtt.IsZero())
     {
-        m_rtt->Measurement(rtt); // Log the measurement
         // RFC 6298, clause 2.4
-        m_rto = Max(m_rtt->GetEstimate() + Max(m_clockGranularity, m_rtt->GetVariation() * 4),
-                    m_minRto);
-        m_tcb->m_srtt = m_rtt->GetEstimate();
+        m_rto = Max(sample.srtt + Max(m_clockGranularity, sample.rttVar * 4), m_minRto);
+        m_tcb->m_srtt = sample.srtt;
         m_tcb->m_minRtt = std::min(m_tcb->m_srtt.Get(), m_tcb->m_minRtt);
-        NS_LOG_INFO(this << m_tcb->m_srtt << m_tcb->m_minRtt);
+        m_tcb->m_windowedMinRtt = sample.minRtt;
+        NS_LOG_INFO(this << m_tcb->m_srtt << m_tcb->m_minRtt << m_tcb->m_windowedMinRtt);
     }
 }
 
@@ -4093,15 +4532,14 @@ TcpSocketBase::NewAck(const SequenceNumber32& ack, bool resetRTO)
                           << (Simulator::Now() + m_rto.Get()).GetSeconds());
         m_retxEvent = Simulator::Schedule(m_rto, &TcpSocketBase::ReTxTimeout, this);
         uint32_t inflight = BytesInFlight();
-        Time rtt = m_rtt->GetEstimate();
 
         // Updating PTO
         if (m_tlpEnabled)
         {
             // Calculate the time left for RTO to expire
-            double rto_left = (Simulator::GetDelayLeft(m_retxEvent).GetSeconds());
+            Time rto_left = Simulator::GetDelayLeft(m_retxEvent);
             // Calculate PTO
-            Time m_pto = m_tlp->CalculatePto(rtt, inflight, (rto_left));
+            Time m_pto = m_tlp->CalculatePto(inflight, rto_left);
 
             // Check if condition for scheduling PTO are satisfied
             // The connection supports SACK [RFC2018]
@@ -4231,6 +4669,9 @@ TcpSocketBase::ReTxTimeout()
     // that we received.
     m_txBuffer->SetSentListLost(resetSack);
 
+    // Every segment is now marked as lost, there is nothing left for RACK
+    m_rackTimer.Cancel();
+
     // From RFC 6675, Section 5.1
     // If an RTO occurs during loss recovery as specified in this document,
     // RecoveryPoint MUST be set to HighData.  Further, the new value of
@@ -4248,6 +4689,11 @@ TcpSocketBase::ReTxTimeout()
 
     // Please don't reset highTxMark, it is used for retransmission detection
 
+    if (m_undoEnabled && (m_tcb->m_congState < TcpSocketState::CA_RECOVERY || !m_undoActive))
+    {
+        InitUndo();
+    }
+
     // When a TCP sender detects segment loss using the retransmission timer
     // and the given segment has not yet been resent by way of the
     // retransmission timer, decrease ssThresh
@@ -4427,6 +4873,11 @@ TcpSocketBase::CancelAllTimers()
     m_sendPendingDataEvent.Cancel();
     m_pacingTimer.Cancel();
     m_tlptimerEvent.Cancel();
+    m_rackTimer.Cancel();
+    // A pending aggregate would never be flushed: drop it with its timer
+    m_groFlushEvent.Cancel();
+    m_groPacket = nullptr;
+    m_groSegments = 0;
 }
 
 /* Move TCP to Time_Wait state and schedule a transition to Closed state */
@@ -4701,7 +5152,19 @@ TcpSocketBase::ProcessOptionSack(const Ptr<const TcpOption> option)
     NS_LOG_FUNCTION(this << option);
 
     Ptr<const TcpOptionSack> s = DynamicCast<const TcpOptionSack>(option);
-    TcpOptionSack::SackList list = s->GetSackList();
+    return ProcessOptionSack(s->GetSackList(), m_txBuffer->HeadSequence());
+}
+
+uint32_t
+TcpSocketBase::ProcessOptionSack(const TcpOptionSack::SackList& list, SequenceNumber32 ackNumber)
+{
+    NS_LOG_FUNCTION(this << ackNumber);
+
+    if (list.empty())
+    {
+        return 0;
+    }
+
     SequenceNumber32 oldHeadSequence = m_txBuffer->HeadSequence();
 
     // Check if the SACK block contains a DSACK
@@ -4744,7 +5207,17 @@ TcpSocketBase::ProcessOptionSack(const Ptr<const TcpOption> option)
         }
     }
 
-    return m_txBuffer->Update(list, MakeCallback(&TcpRateOps::SkbDelivered, m_rateOps));
+    // A D-SACK block below the cumulative ACK of the segment reports data that
+    // the ACK itself discards: it must not mark the head of the scoreboard
+    TcpOptionSack::SackList blocks = list;
+    blocks.remove_if(
+        [ackNumber](const TcpOptionSack::SackBlock& block) { return block.first < ackNumber; });
+    if (blocks.empty())
+    {
+        return 0;
+    }
+
+    return m_txBuffer->Update(blocks, MakeCallback(&TcpSocketBase::SkbDelivered, this));
 }
 
 void
@@ -37,8 +37,11 @@ class TcpRecoveryOps;
 class RttEstimator;
 class TcpRxBuffer;
 class TcpTxBuffer;
+class TcpTxItem;
 class TcpOption;
 class TcpRack;
+class TcpRttSampler;
+struct TcpRttSample;
 class TcpTlp;
 class Ipv4Interface;
 class Ipv6Interface;
@@ -281,6 +284,15 @@ class TcpSocketBase : public TcpSocket
      */
     virtual void SetRtt(Ptr<RttEstimator> rtt);
 
+    /**
+     * @brief Get the RTT sampling service of the connection.
+     *
+     * Subscribe to it to receive the RTT information after every ACK.
+     *
+     * @return the RTT sampler
+     */
+    Ptr<TcpRttSampler> GetRttSampler() const;
+
     /**
      * @brief Sets the Minimum RTO.
      * @param minRto The minimum RTO.
@@ -669,9 +681,18 @@ class TcpSocketBase : public TcpSocket
                                            const Address& peerAddr,
                                            const Ptr<const TcpSocketBase> socket);
 
+    /**
+     * TracedCallback signature for the undo of a spurious window reduction.
+     *
+     * @param [in] cWnd The congestion window restored by the undo.
+     * @param [in] ssThresh The slow start threshold restored by the undo.
+     */
+    typedef void (*UndoTracedCallback)(uint32_t cWnd, uint32_t ssThresh);
+
     // Variables for FACK
-    uint32_t m_sndFack;    //!< Sequence number of the forward most acknowledgement
-    uint32_t m_retranData; //!< Number of outstanding retransmitted bytes
+    uint32_t m_sndFack;      //!< Sequence number of the forward most acknowledgement
+    uint32_t m_priorFack{0}; //!< m_sndFack before the ACK being processed
+    uint32_t m_retranData;   //!< Number of outstanding retransmitted bytes
 
     // D-SACK related variables
     bool m_isDsack{false};   //!< Boolean variable to check if a duplicate packet has arrived
@@ -1116,6 +1137,43 @@ class TcpSocketBase : public TcpSocket
      */
     virtual void ReceivedData(Ptr<Packet> packet, const TcpHeader& tcpHeader);
 
+    /**
+     * @brief Put received data into the buffer, call L7 to get it if
+     *        necessary, and ACK it
+     * @param packet the packet
+     * @param tcpHeader the TCP header of its first segment
+     * @param segments the number of segments the packet aggregates
+     */
+    void ProcessReceivedData(Ptr<Packet> packet, const TcpHeader& tcpHeader, uint32_t segments);
+
+    /**
+     * @brief Receive aggregation (GRO) stage of the received data
+     *
+     * In-order data arriving back to back is merged into one aggregate,
+     * which reaches the Rx buffer, and is ACKed, as a single packet when
+     * it holds GroMaxSegments segments, when GroFlushTimeout expires, or
+     * when a segment that cannot join it arrives. Out-of-order data,
+     * duplicates, FINs and CE-marked data are never aggregated, so that
+     * they are SACKed, DSACKed or echoed at once.
+     *
+     * @param packet the packet
+     * @param tcpHeader the packet's TCP header
+     */
+    void GroReceive(Ptr<Packet> packet, const TcpHeader& tcpHeader);
+
+    /**
+     * @brief Check whether a segment can be appended to the pending aggregate
+     * @param packet the payload of the segment
+     * @param tcpHeader the TCP header of the segment
+     * @returns true if the segment continues the aggregate
+     */
+    bool GroCanMerge(Ptr<const Packet> packet, const TcpHeader& tcpHeader) const;
+
+    /**
+     * @brief Hand the pending aggregate, if any, to the Rx buffer
+     */
+    void GroFlush();
+
     /**
      * @brief Calculate RTT sample for the ACKed packet
      *
@@ -1136,6 +1194,12 @@ class TcpSocketBase : public TcpSocket
      */
     virtual void EstimateRtt(const TcpHeader& tcpHeader);
 
+    /**
+     * @brief Update the RTO and the socket state from the RTT sampler
+     * @param sample the RTT information after the last ACK
+     */
+    void RttSampled(const TcpRttSample& sample);
+
     /**
      * @brief Update the RTT history, when we send TCP segments
      *
@@ -1169,9 +1233,63 @@ class TcpSocketBase : public TcpSocket
 
     /**
      * @brief RACK Loss Detection
+     *
+     * Marks the expired segments as lost and (re)arms the single RACK
+     * reordering timer to the time at which the segments still waiting
+     * for the reordering window would expire. The timer is cancelled if no
+     * segment is waiting. Run after every scoreboard update, in every
+     * congestion state; a loss found outside of CA_RECOVERY and CA_LOSS
+     * starts a fast recovery.
      */
     void RackLoss();
 
+    /**
+     * @brief Save the congestion state before a window reduction
+     *
+     * Called when entering CA_RECOVERY or CA_LOSS, so that the reduction can
+     * be undone if all its retransmissions turn out to be spurious (Linux
+     * tcp_init_undo). An RTO during a recovery keeps the state saved when
+     * the recovery started.
+     */
+    void InitUndo();
+
+    /**
+     * @brief Check whether the current window reduction was spurious
+     *
+     * True when every retransmission of the episode has been reported by a
+     * DSACK, or when the last ACK echoes a timestamp older than the first
+     * retransmission (Eifel detection, RFC 3522): the original transmissions
+     * were delivered.
+     *
+     * @return true if the reduction can be undone
+     */
+    bool MayUndo() const;
+
+    /**
+     * @brief Restore cWnd and ssThresh saved by InitUndo and go back to CA_OPEN
+     */
+    void UndoCwndReduction();
+
+    /**
+     * @brief Expiry of the RACK reordering timer
+     *
+     * Runs the RACK loss detection and retransmits the segments it marks
+     * lost without waiting for the next ACK.
+     */
+    void RackTimeout();
+
+    /**
+     * @brief Called for every segment newly (S)ACKed by the ACK being processed
+     *
+     * Informs the rate algorithms and, with RACK, reports to TcpRack the
+     * never retransmitted segments delivered below the highest SACKed
+     * sequence seen before this ACK, i.e. the segments overtaken by later
+     * ones.
+     *
+     * @param item the delivered segment
+     */
+    void SkbDelivered(TcpTxItem* item);
+
     /**
      * @brief Enter the CA_RECOVERY, and retransmit the head
      *
@@ -1283,6 +1401,23 @@ class TcpSocketBase : public TcpSocket
      */
     uint32_t ProcessOptionSack(const Ptr<const TcpOption> option);
 
+    /**
+     * @brief Process the SACK blocks of a segment
+     *
+     * @param list SACK blocks, as listed in the option
+     * @param ackNumber the cumulative ACK of the segment
+     * @returns the number of bytes sacked by these blocks
+     */
+    uint32_t ProcessOptionSack(const TcpOptionSack::SackList& list, SequenceNumber32 ackNumber);
+
+    /**
+     * @brief Count the retransmissions reported unneeded by a D-SACK
+     *
+     * @param list SACK blocks, as listed in the option
+     * @param ackNumber the cumulative ACK of the segment
+     */
+    void ProcessDsackUndo(const TcpOptionSack::SackList& list, SequenceNumber32 ackNumber);
+
     /**
      * @brief Add the SACK PERMITTED option to the header
      *
@@ -1388,6 +1523,14 @@ class TcpSocketBase : public TcpSocket
     uint32_t m_delAckCount{0};    //!< Delayed ACK counter
     uint32_t m_delAckMaxCount{0}; //!< Number of packet to fire an ACK before delay timeout
 
+    // Receive aggregation (GRO)
+    uint32_t m_groMaxSegments{1};     //!< Maximum number of segments in an aggregate
+    Time m_groFlushTimeout{0};        //!< How long an aggregate waits for more segments
+    Ptr<Packet> m_groPacket{nullptr}; //!< Payload of the pending aggregate, if any
+    TcpHeader m_groHeader;            //!< TCP header of the first segment of the aggregate
+    uint32_t m_groSegments{0};        //!< Number of segments in the pending aggregate
+    EventId m_groFlushEvent{};        //!< Hands the pending aggregate to the Rx buffer
+
     // Nagle algorithm
     bool m_noDelay{false}; //!< Set to true to disable Nagle's algorithm
 
@@ -1418,7 +1561,8 @@ class TcpSocketBase : public TcpSocket
     Callback<void, Ipv6Address, uint8_t, uint8_t, uint8_t, uint32_t>
         m_icmpCallback6; //!< ICMPv6 callback
 
-    Ptr<RttEstimator> m_rtt; //!< Round trip time estimator
+    Ptr<RttEstimator> m_rtt;          //!< Round trip time estimator
+    Ptr<TcpRttSampler> m_rttSampler; //!< Per-ACK RTT sampling, shared with RACK and TLP
 
     // Tx buffer management
     Ptr<TcpTxBuffer> m_txBuffer; //!< Tx buffer
@@ -1452,10 +1596,13 @@ class TcpSocketBase : public TcpSocket
     bool m_timestampEnabled{true};  //!< Timestamp option enabled
     uint32_t m_timestampToEcho{0};  //!< Timestamp to echo
 
-    bool m_fackEnabled{false};  //!< FACK option disabled
-    bool m_dsackEnabled{false}; //!< D-SACK option disabled
-    bool m_rackEnabled{false};  //!< RACK option enabled
-    bool m_tlpEnabled{false};   //!< TLP option enabled
+    bool m_fackEnabled{false};     //!< FACK option disabled
+    bool m_dsackEnabled{false};    //!< D-SACK option disabled
+    bool m_rackEnabled{false};     //!< RACK option enabled
+    bool m_tlpEnabled{false};      //!< TLP option enabled
+    bool m_undoEnabled{false};     //!< Undo of spurious window reductions enabled
+    bool m_tsoEnabled{false};      //!< Super-segments (TSO/GSO) enabled
+    uint32_t m_tsoMaxSegments{16}; //!< Maximum number of segments in a super-segment
 
     EventId m_sendPendingDataEvent{}; //!< micro-delay event to send pending data
 
@@ -1475,12 +1622,23 @@ class TcpSocketBase : public TcpSocket
 
     // RACK related variables
     Ptr<TcpRack> m_rack;
+    EventId m_rackTimer{};                 //!< RACK reordering timer
+    TracedCallback<Time> m_rackTimerTrace; //!< Expiration time of the RACK reordering timer
     Ptr<TcpRateOps> m_rateOps; //!< Rate operations
 
     // TLP related variables
     Ptr<TcpTlp> m_tlp;
     bool m_tlpRound = false;
 
+    // Undo of spurious window reductions
+    bool m_undoActive{false};         //!< The current reduction can be undone (undo_marker set)
+    SequenceNumber32 m_undoMarker{0}; //!< SND.UNA when the reduction started
+    int32_t m_undoRetrans{-1};        //!< Retransmissions not yet DSACKed, -1 if none
+    uint32_t m_retransStamp{0};       //!< TSval of the first retransmission, 0 if none
+    uint32_t m_priorCwnd{0};          //!< cWnd before the reduction
+    uint32_t m_priorSsThresh{0};      //!< ssThresh before the reduction
+    TracedCallback<uint32_t, uint32_t> m_undoTrace; //!< cWnd and ssThresh restored by an undo
+
     // Guesses over the other connection end
     bool m_isFirstPartialAck{true}; //!< First partial ACK during RECOVERY
 
@@ -194,7 +194,8 @@ class TcpSocketState : public Object
     uint16_t m_pacingCaRatio{0};           //!< CA pacing ratio
     bool m_paceInitialWindow{false};       //!< Enable/Disable pacing for the initial window
 
-    Time m_minRtt{Time::Max()}; //!< Minimum RTT observed throughout the connection
+    Time m_minRtt{Time::Max()};         //!< Minimum RTT observed throughout the connection
+    Time m_windowedMinRtt{Time::Max()}; //!< Windowed minimum of the RTT samples (TcpRttSampler)
 
     TracedValue<uint32_t> m_bytesInFlight{0}; //!< Bytes in flight
     bool m_isCwndLimited{false};              //!< Whether throughput is limited by cwnd
@@ -19,9 +19,7 @@ TcpTlp::GetTypeId(void)
 TcpTlp::TcpTlp(void)
     : Object(),
       m_srtt(0),
-      m_alpha(0.125),
-      m_pto(MilliSeconds(2)),
-      m_tlpRtt(0)
+      m_pto(MilliSeconds(2))
 {
     NS_LOG_FUNCTION(this);
 }
@@ -29,10 +27,7 @@ TcpTlp::TcpTlp(void)
 TcpTlp::TcpTlp(const TcpTlp& other)
     : Object(other),
       m_srtt(other.m_srtt),
-      m_alpha(other.m_alpha),
-      m_pto(other.m_pto),
-      m_tlpRtt(other.m_tlpRtt)
-
+      m_pto(other.m_pto)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -42,45 +37,42 @@ TcpTlp::~TcpTlp()
     NS_LOG_FUNCTION(this);
 }
 
-// Calculate the value of PTO
-Time
-TcpTlp::CalculatePto(Time rtt, uint32_t inflight, double rto_left)
+void
+TcpTlp::UpdateRtt(const TcpRttSample& sample)
 {
     NS_LOG_FUNCTION(this);
 
-    Time curr_pto;
-    if (rtt > Seconds(0))
+    if (!sample.rtt.IsZero())
     {
-        m_tlpRtt = rtt;
+        m_srtt = sample.srtt;
     }
+}
 
-    if (m_srtt == 0)
-    {
-        m_srtt = m_tlpRtt.GetSeconds();
-    }
-    else
-    {
-        m_srtt = (1 - m_alpha) * m_srtt + m_alpha * m_tlpRtt.GetSeconds();
-    }
+// Calculate the value of PTO
+Time
+TcpTlp::CalculatePto(uint32_t inflight, Time rto_left)
+{
+    NS_LOG_FUNCTION(this);
 
-    if (m_srtt > 0)
+    Time curr_pto;
+    if (m_srtt.IsStrictlyPositive())
     {
-        curr_pto = 2 * Time::FromDouble(m_srtt, Time::S);
+        curr_pto = 2 * m_srtt;
         if (inflight == 1)
         {
-            curr_pto += Time::FromDouble(0.2, Time::S); // 200ms
+            curr_pto += MilliSeconds(200);
         }
         else
         {
-            curr_pto += Time::FromDouble(0.002, Time::S); // 2ms
+            curr_pto += MilliSeconds(2);
         }
     }
     else
     {
-        curr_pto += Time::FromDouble(1, Time::S);
+        curr_pto += Seconds(1);
     }
 
-    curr_pto = Min(curr_pto, Time::FromDouble(rto_left, Time::S));
+    curr_pto = Min(curr_pto, rto_left);
     return curr_pto;
 }
 } // namespace ns3
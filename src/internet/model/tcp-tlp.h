@@ -14,6 +14,7 @@
 #pragma once
 
 #include "tcp-option-sack.h"
+#include "tcp-rtt-sampler.h"
 #include "tcp-socket-state.h"
 
 #include "ns3/nstime.h"
@@ -51,21 +52,25 @@ class TcpTlp : public Object
      */
     virtual ~TcpTlp();
 
+    /**
+     * @brief Takes srtt from the RTT sampler of the connection
+     *
+     * @param sample the RTT information after the last ACK
+     */
+    void UpdateRtt(const TcpRttSample& sample);
+
     /**
      * @brief Calculates Pto
      *
-     * @param srtt smoother round trip time
      * @param flightsize flight size
-     * @param rto retransmission timeout
+     * @param rto time left before the retransmission timeout expires
      */
-    Time CalculatePto(Time srtt, uint32_t flightsize, double rto);
+    Time CalculatePto(uint32_t flightsize, Time rto);
 
   private:
-    double m_srtt{0};      //!< Smoothened RTT (SRTT) as specified in [RFC6298]
-    double m_alpha{0.125}; //!< EWMA constant for calculation of SRTT (alpha = 1/8)
+    Time m_srtt{0}; //!< Smoothed RTT (SRTT), from the RTT sampler
 
-    Time m_pto{0};    //!< PTO values>
-    Time m_tlpRtt{0}; //!< RTT value used for TLP>
+    Time m_pto{0}; //!< PTO values>
 };
 } // namespace ns3
 
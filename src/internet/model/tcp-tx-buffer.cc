@@ -55,19 +55,10 @@ TcpTxBuffer::TcpTxBuffer(uint32_t n)
 
 TcpTxBuffer::~TcpTxBuffer()
 {
-    for (auto it = m_sentList.begin(); it != m_sentList.end(); ++it)
-    {
-        TcpTxItem* item = *it;
-        m_sentSize -= item->m_packet->GetSize();
-        delete item;
-    }
-
-    for (auto it = m_appList.begin(); it != m_appList.end(); ++it)
-    {
-        TcpTxItem* item = *it;
-        m_size -= item->m_packet->GetSize();
-        delete item;
-    }
+    // The items themselves are freed with the slabs of m_pool
+    m_tsortedList.clear();
+    m_sentList.clear();
+    m_appList.clear();
 }
 
 SequenceNumber32
@@ -191,7 +182,7 @@ TcpTxBuffer::Add(Ptr<Packet> p)
     {
         if (p->GetSize() > 0)
         {
-            auto item = new TcpTxItem();
+            TcpTxItem* item = m_pool.Allocate();
             item->m_packet = p->Copy();
             m_appList.insert(m_appList.end(), item);
             m_size += p->GetSize();
@@ -275,6 +266,7 @@ TcpTxBuffer::CopyFromSequence(uint32_t numBytes, const SequenceNumber32& seq)
     }
 
     outItem->m_lastSent = Simulator::Now();
+    TsortedPushBack(outItem);
     NS_ASSERT_MSG(outItem->m_startSeq >= m_firstByteSeq,
                   "Returning an item " << *outItem << " with SND.UNA as " << m_firstByteSeq);
     ConsistencyCheck();
@@ -295,11 +287,8 @@ TcpTxBuffer::GetNewSegment(uint32_t numBytes)
     item->m_startSeq = startOfAppList;
 
     // Move item from AppList to SentList (should be the first, not too complex)
-    auto it = std::find(m_appList.begin(), m_appList.end(), item);
-    NS_ASSERT(it != m_appList.end());
-
-    m_appList.erase(it);
-    m_sentList.insert(m_sentList.end(), item);
+    m_appList.erase(m_appList.iterator_to(item));
+    IndexInsert(m_sentList.insert(m_sentList.end(), item));
     m_sentSize += item->m_packet->GetSize();
 
     return item;
@@ -381,7 +370,7 @@ TcpTxBuffer::FindHighestSacked() const
 }
 
 void
-TcpTxBuffer::SplitItems(TcpTxItem* t1, TcpTxItem* t2, uint32_t size) const
+TcpTxBuffer::SplitItems(TcpTxItem* t1, TcpTxItem* t2, uint32_t size)
 {
     NS_ASSERT(t1 != nullptr && t2 != nullptr);
     NS_LOG_FUNCTION(this << *t2 << size);
@@ -397,6 +386,14 @@ TcpTxBuffer::SplitItems(TcpTxItem* t1, TcpTxItem* t2, uint32_t size) const
 
     t2->m_startSeq += size;
 
+    if (t2->m_tsorted)
+    {
+        // Both parts have been sent at the same time, but the first one has
+        // the lower sequence number: it goes right before t2
+        m_tsortedList.insert(m_tsortedList.iterator_to(t2), t1);
+        t1->m_tsorted = true;
+    }
+
     NS_LOG_INFO("Split of size " << size << " result: t1 " << *t1 << " t2 " << *t2);
 }
 
@@ -405,7 +402,7 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
                                const SequenceNumber32& listStartFrom,
                                uint32_t numBytes,
                                const SequenceNumber32& seq,
-                               bool* listEdited) const
+                               bool* listEdited)
 {
     NS_LOG_FUNCTION(this << numBytes << seq);
 
@@ -446,7 +443,7 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
     {
         currentItem = *it;
         currentPacket = currentItem->m_packet;
-        NS_ASSERT_MSG(list != m_sentList || currentItem->m_startSeq >= m_firstByteSeq,
+        NS_ASSERT_MSG(&list != &m_sentList || currentItem->m_startSeq >= m_firstByteSeq,
                       "start: " << m_firstByteSeq
                                 << " currentItem start: " << currentItem->m_startSeq);
 
@@ -471,11 +468,16 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
                 NS_LOG_INFO("we are at " << beginOfCurrentPacket << " searching for " << seq
                                          << " and now we recurse because packet ends at "
                                          << beginOfCurrentPacket + currentPacket->GetSize());
-                auto firstPart = new TcpTxItem();
+                TcpTxItem* firstPart = m_pool.Allocate();
                 SplitItems(firstPart, currentItem, seq - beginOfCurrentPacket);
 
                 // insert firstPart before currentItem
-                list.insert(it, firstPart);
+                auto firstPartIt = list.insert(it, firstPart);
+                if (&list == &m_sentList)
+                {
+                    IndexInsert(firstPartIt);
+                    IndexInsert(it);
+                }
                 if (listEdited)
                 {
                     *listEdited = true;
@@ -522,9 +524,13 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
                     TcpTxItem* previous = *(--it);
 
                     list.erase(it);
+                    if (&list == &m_sentList)
+                    {
+                        IndexErase(currentItem->m_startSeq);
+                    }
 
                     MergeItems(previous, currentItem);
-                    delete currentItem;
+                    m_pool.Release(currentItem);
                     if (listEdited)
                     {
                         *listEdited = true;
@@ -537,11 +543,16 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
             {
                 // the end is inside the current packet, but it isn't exactly
                 // the packet end. Just fragment, fix the list, and return.
-                auto firstPart = new TcpTxItem();
+                TcpTxItem* firstPart = m_pool.Allocate();
                 SplitItems(firstPart, currentItem, numBytes);
 
                 // insert firstPart before currentItem
-                list.insert(it, firstPart);
+                auto firstPartIt = list.insert(it, firstPart);
+                if (&list == &m_sentList)
+                {
+                    IndexInsert(firstPartIt);
+                    IndexInsert(it);
+                }
                 if (listEdited)
                 {
                     *listEdited = true;
@@ -571,8 +582,12 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
 
             MergeItems(currentItem, next);
             list.erase(it);
+            if (&list == &m_sentList)
+            {
+                IndexErase(next->m_startSeq);
+            }
 
-            delete next;
+            m_pool.Release(next);
 
             if (listEdited)
             {
@@ -588,7 +603,7 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
 }
 
 void
-TcpTxBuffer::MergeItems(TcpTxItem* t1, TcpTxItem* t2) const
+TcpTxBuffer::MergeItems(TcpTxItem* t1, TcpTxItem* t2)
 {
     NS_ASSERT(t1 != nullptr && t2 != nullptr);
     NS_LOG_FUNCTION(this << *t1 << *t2);
@@ -605,19 +620,30 @@ TcpTxBuffer::MergeItems(TcpTxItem* t1, TcpTxItem* t2) const
     {
         if (t1->m_retrans)
         {
-            auto self = const_cast<TcpTxBuffer*>(this);
-            self->m_retrans -= t1->m_packet->GetSize();
+            m_retrans -= t1->m_packet->GetSize();
             t1->m_retrans = false;
         }
         else
         {
             NS_ASSERT(t2->m_retrans);
-            auto self = const_cast<TcpTxBuffer*>(this);
-            self->m_retrans -= t2->m_packet->GetSize();
+            m_retrans -= t2->m_packet->GetSize();
             t2->m_retrans = false;
         }
     }
 
+    // t2 is going to be deleted. If it was sent more recently, t1 takes its
+    // place in the time-ordered sent list.
+    if (t2->m_tsorted)
+    {
+        if (!t1->m_tsorted || t1->m_lastSent < t2->m_lastSent)
+        {
+            TsortedRemove(t1);
+            m_tsortedList.insert(m_tsortedList.iterator_to(t2), t1);
+            t1->m_tsorted = true;
+        }
+        TsortedRemove(t2);
+    }
+
     if (t1->m_lastSent < t2->m_lastSent)
     {
         t1->m_lastSent = t2->m_lastSent;
@@ -654,38 +680,36 @@ bool
 TcpTxBuffer::IsRetransmittedDataAcked(const SequenceNumber32& ack) const
 {
     NS_LOG_FUNCTION(this);
-    for (const auto& it : m_sentList)
+    auto it = FindSentItem(ack - 1);
+    if (it == m_sentList.end())
     {
-        TcpTxItem* item = it;
-        Ptr<Packet> p = item->m_packet;
-        if (item->m_startSeq + p->GetSize() == ack && !item->m_sacked && item->m_retrans)
-        {
-            return true;
-        }
+        return false;
     }
-    return false;
+
+    const TcpTxItem* item = *it;
+    return item->m_startSeq + item->m_packet->GetSize() == ack && !item->m_sacked &&
+           item->m_retrans;
 }
 
 void
 TcpTxBuffer::GetPacketInfo(SequenceNumber32 ack, TcpTxItem* item)
 {
     NS_LOG_FUNCTION(this);
-    uint32_t pktSize;
 
-    for (auto it = m_sentList.begin(); it != m_sentList.end(); ++it)
+    // Find out the recent most packet acknowledged: the one that ends at ack
+    // or, if it is sacked, the one that starts at ack
+    auto it = FindSentItem(ack - 1);
+    if (it != m_sentList.end() && (*it)->m_startSeq + (*it)->m_packet->GetSize() == ack)
     {
-        TcpTxItem* packet = *it;
-        Ptr<Packet> p = packet->m_packet;
-        pktSize = p->GetSize();
+        *item = *(*it);
+        return;
+    }
 
-        // Find out the recent most packet acknowledged
-        if ((packet->m_startSeq == ack && packet->m_sacked) || packet->m_startSeq + pktSize == ack)
-        {
-            *item = *packet;
-            return;
-        }
+    it = FindSentItem(ack);
+    if (it != m_sentList.end() && (*it)->m_startSeq == ack && (*it)->m_sacked)
+    {
+        *item = *(*it);
     }
-    return;
 }
 
 void
@@ -732,6 +756,8 @@ TcpTxBuffer::DiscardUpTo(const SequenceNumber32& seq, const Callback<void, TcpTx
             m_firstByteSeq += pktSize;
 
             RemoveFromCounts(item, pktSize);
+            TsortedRemove(item);
+            IndexErase(item->m_startSeq);
 
             i = m_sentList.erase(i);
             NS_LOG_INFO("Removed " << *item << " lost: " << m_lostOut << " retrans: " << m_retrans
@@ -743,7 +769,7 @@ TcpTxBuffer::DiscardUpTo(const SequenceNumber32& seq, const Callback<void, TcpTx
                 beforeDelCb(item);
             }
 
-            delete item;
+            m_pool.Release(item);
         }
         else if (offset > 0)
         { // Part of the packet is behind the seqnum. Fragment
@@ -751,7 +777,9 @@ TcpTxBuffer::DiscardUpTo(const SequenceNumber32& seq, const Callback<void, TcpTx
             NS_LOG_INFO(*item);
             // PacketTags are preserved when fragmenting
             item->m_packet = item->m_packet->CreateFragment(offset, pktSize);
+            IndexErase(item->m_startSeq);
             item->m_startSeq += offset;
+            IndexInsert(i);
             m_size -= offset;
             m_sentSize -= offset;
             m_firstByteSeq += offset;
@@ -818,75 +846,84 @@ TcpTxBuffer::Update(const TcpOptionSack::SackList& list, const Callback<void, Tc
         return false;
     }
 
-    for (auto option_it = list.begin(); option_it != list.end(); ++option_it)
-    {
-        auto item_it = m_sentList.begin();
-        SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
+    // Process the blocks in sequence order: each block starts from the index
+    // entry of its left edge, and blocks beyond the sent list end the update
+    TcpOptionSack::SackList blocks = list;
+    blocks.sort([](const TcpOptionSack::SackBlock& a, const TcpOptionSack::SackBlock& b) {
+        return a.first < b.first;
+    });
 
+    for (auto option_it = blocks.begin(); option_it != blocks.end(); ++option_it)
+    {
         if (m_firstByteSeq + m_sentSize < (*option_it).first)
         {
             NS_LOG_INFO("Not updating scoreboard, the option block is outside the sent list");
-            return bytesSacked;
+            break;
         }
 
+        auto index_it = m_seqIndex.lower_bound((*option_it).first);
+        if (index_it == m_seqIndex.end())
+        {
+            continue;
+        }
+
+        auto item_it = index_it->second;
         while (item_it != m_sentList.end())
         {
             uint32_t pktSize = (*item_it)->m_packet->GetSize();
+            SequenceNumber32 beginOfCurrentPacket = (*item_it)->m_startSeq;
 
             // Check the boundary of this packet ... only mark as sacked if
             // it is precisely mapped over the option. It means that if the receiver
             // is reporting as sacked single range bytes that are not mapped 1:1
             // in what we have, the option is discarded. There's room for improvement
             // here.
-            if (beginOfCurrentPacket >= (*option_it).first &&
-                beginOfCurrentPacket + pktSize <= (*option_it).second)
+            if (beginOfCurrentPacket + pktSize > (*option_it).second)
+            {
+                // We already passed the received block end. Exit from the loop
+                NS_LOG_INFO("Received block [" << *option_it << ", checking sentList for block "
+                                               << *(*item_it) << "], not found, breaking loop");
+                break;
+            }
+
+            if ((*item_it)->m_sacked)
             {
-                if ((*item_it)->m_sacked)
+                NS_ASSERT(!(*item_it)->m_lost);
+                NS_LOG_INFO("Received block " << *option_it << ", checking sentList for block "
+                                              << *(*item_it)
+                                              << ", found in the sackboard already sacked");
+            }
+            else
+            {
+                if ((*item_it)->m_lost)
                 {
-                    NS_ASSERT(!(*item_it)->m_lost);
-                    NS_LOG_INFO("Received block " << *option_it << ", checking sentList for block "
-                                                  << *(*item_it)
-                                                  << ", found in the sackboard already sacked");
+                    (*item_it)->m_lost = false;
+                    m_lostOut -= (*item_it)->m_packet->GetSize();
                 }
-                else
-                {
-                    if ((*item_it)->m_lost)
-                    {
-                        (*item_it)->m_lost = false;
-                        m_lostOut -= (*item_it)->m_packet->GetSize();
-                    }
 
-                    (*item_it)->m_sacked = true;
-                    m_sackedOut += (*item_it)->m_packet->GetSize();
-                    bytesSacked += (*item_it)->m_packet->GetSize();
+                (*item_it)->m_sacked = true;
+                TsortedRemove(*item_it);
+                m_sackedOut += (*item_it)->m_packet->GetSize();
+                bytesSacked += (*item_it)->m_packet->GetSize();
 
-                    if (m_highestSack.first == m_sentList.end() ||
-                        m_highestSack.second <= beginOfCurrentPacket + pktSize)
-                    {
-                        m_sackSeen = true;
-                        m_highestSack = std::make_pair(item_it, beginOfCurrentPacket);
-                    }
+                if (m_highestSack.first == m_sentList.end() ||
+                    m_highestSack.second <= beginOfCurrentPacket + pktSize)
+                {
+                    m_sackSeen = true;
+                    m_highestSack = std::make_pair(item_it, beginOfCurrentPacket);
+                }
 
-                    NS_LOG_INFO("Received block "
-                                << *option_it << ", checking sentList for block " << *(*item_it)
-                                << ", found in the sackboard, sacking, current highSack: "
-                                << m_highestSack.second);
+                NS_LOG_INFO("Received block "
+                            << *option_it << ", checking sentList for block " << *(*item_it)
+                            << ", found in the sackboard, sacking, current highSack: "
+                            << m_highestSack.second);
 
-                    if (!sackedCb.IsNull())
-                    {
-                        sackedCb(*item_it);
-                    }
+                if (!sackedCb.IsNull())
+                {
+                    sackedCb(*item_it);
                 }
             }
-            else if (beginOfCurrentPacket + pktSize > (*option_it).second)
-            {
-                // We already passed the received block end. Exit from the loop
-                NS_LOG_INFO("Received block [" << *option_it << ", checking sentList for block "
-                                               << *(*item_it) << "], not found, breaking loop");
-                break;
-            }
 
-            beginOfCurrentPacket += pktSize;
             ++item_it;
         }
     }
@@ -955,37 +992,38 @@ TcpTxBuffer::UpdateLostCount()
 }
 
 void
-TcpTxBuffer::DetectRackLoss(Ptr<TcpRack> rack, double* timeout)
+TcpTxBuffer::DetectRackLoss(Ptr<TcpRack> rack, Time* timeout)
 {
     NS_LOG_FUNCTION(this);
 
-    for (auto it = m_sentList.begin(); it != m_sentList.end(); ++it)
+    auto it = m_tsortedList.begin();
+    while (it != m_tsortedList.end())
     {
         TcpTxItem* item = *it;
 
-        if (item->m_sacked)
-        {
-            continue;
-        }
-
-        // Packet lost but not retransmitted
-        if ((item->m_lost && !item->m_retrans)) // Confirm this condition
+        // Packet sacked, or lost but not retransmitted: it is not of interest
+        // for RACK until it is sent again
+        if (item->m_sacked || (item->m_lost && !item->m_retrans))
         {
+            item->m_tsorted = false;
+            it = m_tsortedList.erase(it);
             continue;
         }
 
-        else if (!rack->SentAfter(rack->GetXmitTs(),
-                                  item->m_lastSent,
-                                  rack->GetEndSeq(),
-                                  item->m_startSeq.GetValue() + item->m_packet->GetSize()))
+        // The list is ordered by transmission time, so all the following
+        // packets have been sent after Rack.packet as well
+        if (!rack->SentAfter(rack->GetXmitTs(),
+                             item->m_lastSent,
+                             rack->GetEndSeq(),
+                             item->m_startSeq.GetValue() + item->m_packet->GetSize()))
         {
             break;
         }
 
-        double remaining = item->m_lastSent.GetMilliSeconds() + rack->GetRtt().GetMilliSeconds() +
-                           rack->GetReoWnd() - Simulator::Now().GetMilliSeconds();
+        Time remaining =
+            item->m_lastSent + rack->GetRtt() + rack->GetReoWnd() - Simulator::Now();
 
-        if (remaining <= 0)
+        if (!remaining.IsStrictlyPositive())
         {
             if (!item->m_lost)
             {
@@ -998,17 +1036,101 @@ TcpTxBuffer::DetectRackLoss(Ptr<TcpRack> rack, double* timeout)
                 item->m_retrans = false;
                 m_retrans -= item->m_packet->GetSize();
             }
+
+            if (!item->m_retrans)
+            {
+                item->m_tsorted = false;
+                it = m_tsortedList.erase(it);
+                continue;
+            }
         }
         else
         {
-            *timeout = std::max(remaining, *timeout);
+            *timeout = Max(remaining, *timeout);
         }
+        ++it;
     }
 
     ConsistencyCheck();
     return;
 }
 
+TcpTxBuffer::PacketList::const_iterator
+TcpTxBuffer::FindSentItem(const SequenceNumber32& seq) const
+{
+    // The entry with the highest starting sequence not greater than seq
+    auto index_it = m_seqIndex.upper_bound(seq);
+    if (index_it == m_seqIndex.begin())
+    {
+        return m_sentList.end();
+    }
+    --index_it;
+
+    const TcpTxItem* item = *(index_it->second);
+    if (seq < item->m_startSeq + item->m_packet->GetSize())
+    {
+        return index_it->second;
+    }
+    return m_sentList.end();
+}
+
+void
+TcpTxBuffer::IndexInsert(PacketList::iterator it)
+{
+    m_seqIndex.insert_or_assign((*it)->m_startSeq, it);
+}
+
+void
+TcpTxBuffer::IndexErase(const SequenceNumber32& seq)
+{
+    m_seqIndex.erase(seq);
+}
+
+void
+TcpTxBuffer::TsortedPushBack(TcpTxItem* item)
+{
+    NS_LOG_FUNCTION(this << *item);
+    TsortedRemove(item);
+    m_tsortedList.push_back(item);
+    item->m_tsorted = true;
+}
+
+void
+TcpTxBuffer::TsortedRemove(TcpTxItem* item)
+{
+    if (item->m_tsorted)
+    {
+        m_tsortedList.erase(m_tsortedList.iterator_to(item));
+        item->m_tsorted = false;
+    }
+}
+
+void
+TcpTxBuffer::RebuildTsortedList()
+{
+    NS_LOG_FUNCTION(this);
+
+    for (auto item : m_tsortedList)
+    {
+        item->m_tsorted = false;
+    }
+    m_tsortedList.clear();
+
+    for (auto item : m_sentList)
+    {
+        if (!item->m_sacked && !(item->m_lost && !item->m_retrans))
+        {
+            m_tsortedList.push_back(item);
+            item->m_tsorted = true;
+        }
+    }
+
+    // The sort is stable, so items sent at the same time keep the sequence order
+    m_tsortedList.sort([](const TcpTxItem* a, const TcpTxItem* b) {
+        return a->m_lastSent < b->m_lastSent;
+    });
+}
+
 bool
 TcpTxBuffer::IsLost(const SequenceNumber32& seq) const
 {
@@ -1019,25 +1141,21 @@ TcpTxBuffer::IsLost(const SequenceNumber32& seq) const
         return false;
     }
 
-    // In theory, using a map and hints when inserting elements can improve
-    // performance
-    for (auto it = m_sentList.begin(); it != m_sentList.end(); ++it)
+    auto it = FindSentItem(seq);
+    if (it == m_sentList.end())
     {
-        // Search for the right iterator before calling IsLost()
-        if ((*it)->m_startSeq <= seq && seq < (*it)->m_startSeq + (*it)->m_packet->GetSize())
-        {
-            if ((*it)->m_lost)
-            {
-                NS_LOG_INFO("seq=" << seq << " is lost because of lost flag");
-                return true;
-            }
+        return false;
+    }
 
-            if ((*it)->m_sacked)
-            {
-                NS_LOG_INFO("seq=" << seq << " is not lost because of sacked flag");
-                return false;
-            }
-        }
+    if ((*it)->m_lost)
+    {
+        NS_LOG_INFO("seq=" << seq << " is lost because of lost flag");
+        return true;
+    }
+
+    if ((*it)->m_sacked)
+    {
+        NS_LOG_INFO("seq=" << seq << " is not lost because of sacked flag");
     }
 
     return false;
@@ -1303,6 +1421,25 @@ TcpTxBuffer::ResetRenoSack()
 
     m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
     m_sackSeen = false;
+
+    // Segments that were sacked are now eligible again for RACK
+    RebuildTsortedList();
+}
+
+void
+TcpTxBuffer::ClearLostMarks()
+{
+    NS_LOG_FUNCTION(this);
+
+    m_lostOut = 0;
+    for (auto it = m_sentList.begin(); it != m_sentList.end(); ++it)
+    {
+        (*it)->m_lost = false;
+    }
+
+    // Segments that were lost and not retransmitted are now eligible again for RACK
+    RebuildTsortedList();
+    ConsistencyCheck();
 }
 
 void
@@ -1322,10 +1459,12 @@ TcpTxBuffer::ResetSentList()
     while (!m_sentList.empty())
     {
         item = m_sentList.back();
-        item->m_retrans = item->m_sacked = item->m_lost = false;
-        m_appList.push_front(item);
+        item->m_retrans = item->m_sacked = item->m_lost = item->m_tsorted = false;
         m_sentList.pop_back();
+        m_appList.push_front(item);
     }
+    m_tsortedList.clear();
+    m_seqIndex.clear();
 
     m_sentSize = 0;
     m_lostOut = 0;
@@ -1344,6 +1483,8 @@ TcpTxBuffer::ResetLastSegmentSent()
         TcpTxItem* item = m_sentList.back();
 
         m_sentList.pop_back();
+        TsortedRemove(item);
+        IndexErase(item->m_startSeq);
         m_sentSize -= item->m_packet->GetSize();
         if (item->m_retrans)
         {
@@ -1395,8 +1536,12 @@ TcpTxBuffer::SetSentListLost(bool resetSack)
         }
 
         (*it)->m_retrans = false;
+        (*it)->m_tsorted = false;
     }
 
+    // Every item is now either sacked or lost and not retransmitted
+    m_tsortedList.clear();
+
     NS_LOG_INFO("Set sent list lost, status: " << *this);
     NS_ASSERT_MSG(m_sentSize >= m_sackedOut + m_lostOut, *this);
     ConsistencyCheck();
@@ -1458,6 +1603,7 @@ TcpTxBuffer::MarkHeadAsLost()
             m_sentList.front()->m_lost = true;
             m_lostOut += m_sentList.front()->m_packet->GetSize();
         }
+        TsortedRemove(m_sentList.front());
     }
     ConsistencyCheck();
 }
@@ -1491,6 +1637,7 @@ TcpTxBuffer::AddRenoSack()
     if (it != m_sentList.end())
     {
         (*it)->m_sacked = true;
+        TsortedRemove(*it);
         m_sackedOut += (*it)->m_packet->GetSize();
         m_sackSeen = true;
         m_highestSack = std::make_pair(it, (*it)->m_startSeq);
@@ -1540,6 +1687,8 @@ TcpTxBuffer::ConsistencyCheck() const
     NS_ASSERT_MSG(lost == m_lostOut, " Counted lost: " << lost << " stored lost: " << m_lostOut);
     NS_ASSERT_MSG(retrans == m_retrans,
                   " Counted retrans: " << retrans << " stored retrans: " << m_retrans);
+    NS_ASSERT_MSG(m_seqIndex.size() == m_sentList.size(),
+                  " Indexed items: " << m_seqIndex.size() << " sent items: " << m_sentList.size());
 }
 
 std::ostream&
@@ -19,6 +19,8 @@
 #include "ns3/sequence-number.h"
 #include "ns3/traced-value.h"
 
+#include <map>
+
 namespace ns3
 {
 class Packet;
@@ -65,6 +67,14 @@ class Packet;
  * documentation) and maintaining the scoreboard is a matter of travelling the
  * list and set the SACK flag on the corresponding segment sent.
  *
+ * To avoid walking the list from its head for every lookup, the items of the
+ * SentList are also indexed by their starting sequence number. The index is
+ * shared by the scoreboard update (Update), and by the queries on a single
+ * sequence (IsLost, GetPacketInfo, IsRetransmittedDataAcked). The SACK blocks
+ * of an option are processed in increasing sequence order, each one resuming
+ * from the index entry of its left edge, so that the sent list is traversed
+ * at most once per option.
+ *
  * Item properties
  * ---------------
  *
@@ -97,6 +107,18 @@ class Packet;
  * of the methods. To have a look how the calculations are made, please see
  * BytesInFlight method.
  *
+ * Time-ordered sent list
+ * ----------------------
+ *
+ * RACK (RFC 8985) reasons about segments in the order in which they were
+ * (re)transmitted, not in sequence order. Besides the SentList, the class
+ * keeps a second list of the same items ordered by their last transmission
+ * time (the equivalent of the Linux "tsorted" queue). An item is appended to
+ * its tail every time it is sent or retransmitted, and it is removed from the
+ * list when it is SACKed, discarded, or marked as lost and not retransmitted
+ * yet. In this way, DetectRackLoss visits only the segments that RACK may
+ * consider, and it stops at the first one sent after RACK.xmit_ts.
+ *
  * Lost segments
  * -------------
  *
@@ -225,10 +247,13 @@ class TcpTxBuffer : public Object
     /**
      * @brief Marks the expired packets as lost according to RACK
      *
+     * The time-ordered sent list is walked from the oldest transmission, and
+     * the walk stops at the first segment sent after RACK.xmit_ts.
+     *
      * @param rack is the pointer to the RACK objective
      * @param timeout is the minimum timeout value for the packets to expire
      */
-    void DetectRackLoss(Ptr<TcpRack> rack, double* timeout);
+    void DetectRackLoss(Ptr<TcpRack> rack, Time* timeout);
 
     /**
      * @brief Returns the number of bytes from the buffer in the range [seq, tailSequence)
@@ -423,6 +448,15 @@ class TcpTxBuffer : public Object
      */
     void ResetRenoSack();
 
+    /**
+     * @brief Clear the lost mark of every segment in the sent list
+     *
+     * Used when a window reduction is undone: the segments marked lost were
+     * not lost after all, so they count again as in flight and become
+     * eligible again for RACK. The retransmitted and SACK flags are kept.
+     */
+    void ClearLostMarks();
+
     /**
      * @brief Set callback to obtain receiver window value
      * @param rWndCallback receiver window callback
@@ -432,7 +466,12 @@ class TcpTxBuffer : public Object
   private:
     friend std::ostream& operator<<(std::ostream& os, const TcpTxBuffer& tcpTxBuf);
 
-    typedef std::list<TcpTxItem*> PacketList; //!< container for data stored in the buffer
+    typedef TcpTxItemList<&TcpTxItem::m_link>
+        PacketList; //!< container for data stored in the buffer
+    typedef TcpTxItemList<&TcpTxItem::m_tsortedLink>
+        TsortedList; //!< container of the sent items, ordered by transmission time
+    typedef std::map<SequenceNumber32, PacketList::iterator>
+        SeqIndex; //!< index of the sent list, keyed on the starting sequence of the items
 
     /**
      * @brief Update the lost count
@@ -585,7 +624,7 @@ class TcpTxBuffer : public Object
                                  const SequenceNumber32& startingSeq,
                                  uint32_t numBytes,
                                  const SequenceNumber32& requestedSeq,
-                                 bool* listEdited = nullptr) const;
+                                 bool* listEdited = nullptr);
 
     /**
      * @brief Merge two TcpTxItem
@@ -597,7 +636,7 @@ class TcpTxBuffer : public Object
      * @param t1 first item
      * @param t2 second item
      */
-    void MergeItems(TcpTxItem* t1, TcpTxItem* t2) const;
+    void MergeItems(TcpTxItem* t1, TcpTxItem* t2);
 
     /**
      * @brief Split one TcpTxItem
@@ -609,7 +648,49 @@ class TcpTxBuffer : public Object
      * @param t2 second item
      * @param size Size to split
      */
-    void SplitItems(TcpTxItem* t1, TcpTxItem* t2, uint32_t size) const;
+    void SplitItems(TcpTxItem* t1, TcpTxItem* t2, uint32_t size);
+
+    /**
+     * @brief Get the item of the sent list that contains a sequence number
+     * @param seq the sequence number to look for
+     * @return an iterator to the item containing seq, or m_sentList.end()
+     */
+    PacketList::const_iterator FindSentItem(const SequenceNumber32& seq) const;
+
+    /**
+     * @brief Add (or update) the index entry of an item of the sent list
+     * @param it iterator to the item inside m_sentList
+     */
+    void IndexInsert(PacketList::iterator it);
+
+    /**
+     * @brief Remove the index entry keyed on a starting sequence
+     * @param seq the starting sequence of the item removed from the sent list
+     */
+    void IndexErase(const SequenceNumber32& seq);
+
+    /**
+     * @brief Move an item to the tail of the time-ordered sent list
+     *
+     * To be called every time the item is (re)transmitted.
+     *
+     * @param item the item just sent
+     */
+    void TsortedPushBack(TcpTxItem* item);
+
+    /**
+     * @brief Remove an item from the time-ordered sent list, if present
+     * @param item the item to remove
+     */
+    void TsortedRemove(TcpTxItem* item);
+
+    /**
+     * @brief Rebuild the time-ordered sent list from the sent list
+     *
+     * Used when flags are reset on many items at once (e.g., when the SACK
+     * information is discarded) and segments become eligible again for RACK.
+     */
+    void RebuildTsortedList();
 
     /**
      * @brief Check if the values of sacked, lost, retrans, are in sync
@@ -623,8 +704,11 @@ class TcpTxBuffer : public Object
      */
     std::pair<TcpTxBuffer::PacketList::const_iterator, SequenceNumber32> FindHighestSacked() const;
 
+    TcpTxItemPool m_pool;              //!< Storage of the items of all the lists
     PacketList m_appList;              //!< Buffer for application data
     PacketList m_sentList;             //!< Buffer for sent (but not acked) data
+    TsortedList m_tsortedList;         //!< Sent items ordered by last transmission time
+    SeqIndex m_seqIndex;               //!< Sent items indexed by starting sequence
     uint32_t m_maxBuffer;              //!< Max number of data bytes in buffer (SND.WND)
     uint32_t m_size;                   //!< Size of all data in this buffer
     uint32_t m_sentSize;               //!< Size of sent (and not discarded) segments
@@ -52,6 +52,12 @@ TcpTxItem::GetSeqSize() const
     return m_packet && m_packet->GetSize() > 0 ? m_packet->GetSize() : 1;
 }
 
+SequenceNumber32
+TcpTxItem::GetStartSeq() const
+{
+    return m_startSeq;
+}
+
 bool
 TcpTxItem::IsSacked() const
 {
@@ -88,4 +94,55 @@ TcpTxItem::GetRateInformation()
     return m_rateInfo;
 }
 
+TcpTxItemPool::TcpTxItemPool(const TcpTxItemPool&)
+{
+}
+
+TcpTxItem*
+TcpTxItemPool::Allocate()
+{
+    if (m_free == nullptr)
+    {
+        m_slabs.emplace_back(new TcpTxItem[SLAB_ITEMS]);
+        TcpTxItem* slab = m_slabs.back().get();
+        for (uint32_t i = 0; i < SLAB_ITEMS; i++)
+        {
+            slab[i].m_link.next = m_free;
+            m_free = &slab[i];
+        }
+    }
+
+    TcpTxItem* item = m_free;
+    m_free = item->m_link.next;
+    item->m_link.next = nullptr;
+    m_inUse++;
+    return item;
+}
+
+void
+TcpTxItemPool::Release(TcpTxItem* item)
+{
+    NS_ASSERT(item != nullptr && m_inUse > 0);
+    NS_ASSERT(item->m_link.prev == nullptr && item->m_link.next == nullptr);
+    NS_ASSERT(!item->m_tsorted);
+
+    // Reset the content (and drop the packet now), keep the links
+    *item = TcpTxItem();
+    item->m_link.next = m_free;
+    m_free = item;
+    m_inUse--;
+}
+
+uint32_t
+TcpTxItemPool::GetSlabs() const
+{
+    return m_slabs.size();
+}
+
+uint32_t
+TcpTxItemPool::GetInUse() const
+{
+    return m_inUse;
+}
+
 } // namespace ns3
@@ -7,12 +7,52 @@
 #ifndef TCP_TX_ITEM_H
 #define TCP_TX_ITEM_H
 
+#include "ns3/assert.h"
 #include "ns3/nstime.h"
 #include "ns3/packet.h"
 #include "ns3/sequence-number.h"
 
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <vector>
+
 namespace ns3
 {
+
+class TcpTxItem;
+
+/**
+ * @ingroup tcp
+ *
+ * @brief Links of a TcpTxItem inside a TcpTxItemList
+ *
+ * The links belong to the position of the item, not to its content: they
+ * are not copied with the item.
+ */
+struct TcpTxItemLink
+{
+    TcpTxItemLink() = default;
+
+    /**
+     * @brief Copy constructor: the copy is not linked
+     */
+    TcpTxItemLink(const TcpTxItemLink&)
+    {
+    }
+
+    /**
+     * @brief Assignment: the links are left untouched
+     * @return this object
+     */
+    TcpTxItemLink& operator=(const TcpTxItemLink&)
+    {
+        return *this;
+    }
+
+    TcpTxItem* prev{nullptr}; //!< Previous item in the list
+    TcpTxItem* next{nullptr}; //!< Next item in the list
+};
 /**
  * @ingroup tcp
  *
@@ -37,6 +77,12 @@ class TcpTxItem
      */
     uint32_t GetSeqSize() const;
 
+    /**
+     * @brief Get the sequence number of the first byte of the item
+     * @return the start sequence number (meaningful only once transmitted)
+     */
+    SequenceNumber32 GetStartSeq() const;
+
     /**
      * @brief Is the item sacked?
      * @return true if the item is sacked, false otherwise
@@ -92,10 +138,15 @@ class TcpTxItem
 
     bool m_retrans{false}; //!< Indicates if the segment is retransmitted
 
+    // Links of the intrusive lists of TcpTxBuffer, not copied with the item
+    TcpTxItemLink m_link;        //!< Links inside the application or the sent list
+    TcpTxItemLink m_tsortedLink; //!< Links inside the time-ordered sent list
+
   private:
     // Only TcpTxBuffer is allowed to touch this part of the TcpTxItem, to manage
     // its internal lists and counters
     friend class TcpTxBuffer;
+    friend class TcpTxItemPool;
 
     SequenceNumber32 m_startSeq{0}; //!< Sequence number of the item (if transmitted)
     Ptr<Packet> m_packet{nullptr};  //!< Application packet (can be null)
@@ -105,6 +156,347 @@ class TcpTxItem
     bool m_sacked{false}; //!< Indicates if the segment has been SACKed
 
     RateInformation m_rateInfo; //!< Rate information of the item
+
+    bool m_tsorted{false}; //!< Indicates if the item is inside the time-ordered sent list
+};
+
+/**
+ * @ingroup tcp
+ *
+ * @brief Intrusive doubly linked list of TcpTxItem
+ *
+ * The links are the TcpTxItemLink member selected by the template
+ * parameter, so that inserting or removing an item allocates nothing and an
+ * item can be on several lists (one per link member) at the same time. The
+ * interface is the subset of std::list<TcpTxItem*> used by TcpTxBuffer.
+ * The list does not own the items.
+ */
+template <TcpTxItemLink TcpTxItem::*Link>
+class TcpTxItemList
+{
+  public:
+    /**
+     * @brief Bidirectional iterator over the items of the list
+     */
+    class iterator
+    {
+      public:
+        using iterator_category = std::bidirectional_iterator_tag; //!< Iterator category
+        using value_type = TcpTxItem*;                              //!< Value type
+        using difference_type = std::ptrdiff_t;                     //!< Difference type
+        using pointer = TcpTxItem* const*;                          //!< Pointer type
+        using reference = TcpTxItem* const&;                        //!< Reference type
+
+        iterator() = default;
+
+        /**
+         * @brief Constructor
+         * @param item the item, nullptr for the end of the list
+         * @param list the list
+         */
+        iterator(TcpTxItem* item, const TcpTxItemList* list)
+            : m_item(item),
+              m_list(list)
+        {
+        }
+
+        /**
+         * @return the item
+         */
+        reference operator*() const
+        {
+            return m_item;
+        }
+
+        /**
+         * @return the next position
+         */
+        iterator& operator++()
+        {
+            m_item = (m_item->*Link).next;
+            return *this;
+        }
+
+        /**
+         * @return the current position, before moving to the next one
+         */
+        iterator operator++(int)
+        {
+            iterator old = *this;
+            ++(*this);
+            return old;
+        }
+
+        /**
+         * @return the previous position
+         */
+        iterator& operator--()
+        {
+            m_item = m_item ? (m_item->*Link).prev : m_list->m_tail;
+            return *this;
+        }
+
+        /**
+         * @return the current position, before moving to the previous one
+         */
+        iterator operator--(int)
+        {
+            iterator old = *this;
+            --(*this);
+            return old;
+        }
+
+        /**
+         * @param other another iterator
+         * @return true if both point to the same position
+         */
+        bool operator==(const iterator& other) const
+        {
+            return m_item == other.m_item;
+        }
+
+        /**
+         * @param other another iterator
+         * @return true if the positions differ
+         */
+        bool operator!=(const iterator& other) const
+        {
+            return m_item != other.m_item;
+        }
+
+      private:
+        TcpTxItem* m_item{nullptr};           //!< The item, nullptr at the end
+        const TcpTxItemList* m_list{nullptr}; //!< The list
+    };
+
+    using const_iterator = iterator; //!< The items are not owned: one iterator type
+
+    TcpTxItemList() = default;
+
+    /**
+     * @brief Copy constructor
+     *
+     * An item can be linked in one list only, so only empty lists can be
+     * copied.
+     *
+     * @param other the list to copy
+     */
+    TcpTxItemList(const TcpTxItemList& other)
+    {
+        NS_ASSERT_MSG(other.empty(), "Copying a list of linked items");
+    }
+
+    TcpTxItemList& operator=(const TcpTxItemList&) = delete;
+
+    ~TcpTxItemList()
+    {
+        clear();
+    }
+
+    /**
+     * @return an iterator to the first item
+     */
+    iterator begin() const
+    {
+        return iterator(m_head, this);
+    }
+
+    /**
+     * @return an iterator past the last item
+     */
+    iterator end() const
+    {
+        return iterator(nullptr, this);
+    }
+
+    /**
+     * @param item an item of the list
+     * @return an iterator to the item
+     */
+    iterator iterator_to(TcpTxItem* item) const
+    {
+        return iterator(item, this);
+    }
+
+    /**
+     * @return true if the list is empty
+     */
+    bool empty() const
+    {
+        return m_head == nullptr;
+    }
+
+    /**
+     * @return the number of items in the list
+     */
+    std::size_t size() const
+    {
+        return m_size;
+    }
+
+    /**
+     * @return the first item
+     */
+    TcpTxItem* front() const
+    {
+        return m_head;
+    }
+
+    /**
+     * @return the last item
+     */
+    TcpTxItem* back() const
+    {
+        return m_tail;
+    }
+
+    /**
+     * @brief Insert an item before a position
+     * @param pos the position
+     * @param item the item, not in the list
+     * @return an iterator to the inserted item
+     */
+    iterator insert(iterator pos, TcpTxItem* item)
+    {
+        TcpTxItem* next = *pos;
+        TcpTxItem* prev = next ? (next->*Link).prev : m_tail;
+        (item->*Link).prev = prev;
+        (item->*Link).next = next;
+        (prev ? (prev->*Link).next : m_head) = item;
+        (next ? (next->*Link).prev : m_tail) = item;
+        m_size++;
+        return iterator(item, this);
+    }
+
+    /**
+     * @param item the item to append
+     */
+    void push_back(TcpTxItem* item)
+    {
+        insert(end(), item);
+    }
+
+    /**
+     * @param item the item to prepend
+     */
+    void push_front(TcpTxItem* item)
+    {
+        insert(begin(), item);
+    }
+
+    /**
+     * @brief Remove the last item
+     */
+    void pop_back()
+    {
+        erase(iterator(m_tail, this));
+    }
+
+    /**
+     * @brief Remove an item
+     * @param pos the position of the item
+     * @return an iterator to the item that followed it
+     */
+    iterator erase(iterator pos)
+    {
+        TcpTxItem* item = *pos;
+        NS_ASSERT(item != nullptr);
+        TcpTxItem* prev = (item->*Link).prev;
+        TcpTxItem* next = (item->*Link).next;
+        (prev ? (prev->*Link).next : m_head) = next;
+        (next ? (next->*Link).prev : m_tail) = prev;
+        (item->*Link).prev = nullptr;
+        (item->*Link).next = nullptr;
+        m_size--;
+        return iterator(next, this);
+    }
+
+    /**
+     * @brief Remove all the items
+     */
+    void clear()
+    {
+        while (m_head)
+        {
+            erase(begin());
+        }
+    }
+
+    /**
+     * @brief Stable sort of the items
+     * @param comp strict weak ordering of two items
+     */
+    template <typename Compare>
+    void sort(Compare comp)
+    {
+        std::vector<TcpTxItem*> items(begin(), end());
+        std::stable_sort(items.begin(), items.end(), comp);
+        clear();
+        for (TcpTxItem* item : items)
+        {
+            push_back(item);
+        }
+    }
+
+  private:
+    TcpTxItem* m_head{nullptr}; //!< First item
+    TcpTxItem* m_tail{nullptr}; //!< Last item
+    std::size_t m_size{0};      //!< Number of items
+};
+
+/**
+ * @ingroup tcp
+ *
+ * @brief Slab allocator of TcpTxItem
+ *
+ * Every TcpTxBuffer owns a pool: the items are allocated in slabs, and the
+ * released items are kept on a free list (through their links) to be reused
+ * for the following segments. A bulk transfer therefore reaches a steady
+ * state in which adding, splitting, merging and discarding items do not
+ * allocate memory.
+ */
+class TcpTxItemPool
+{
+  public:
+    TcpTxItemPool() = default;
+
+    /**
+     * @brief Copy constructor: the copy starts empty
+     *
+     * Items are never shared between buffers.
+     */
+    TcpTxItemPool(const TcpTxItemPool&);
+
+    TcpTxItemPool& operator=(const TcpTxItemPool&) = delete;
+
+    /**
+     * @brief Get an item in its default state
+     * @return the item
+     */
+    TcpTxItem* Allocate();
+
+    /**
+     * @brief Give back an item, which must not be on any list
+     * @param item the item
+     */
+    void Release(TcpTxItem* item);
+
+    /**
+     * @return the number of slabs allocated so far
+     */
+    uint32_t GetSlabs() const;
+
+    /**
+     * @return the number of items currently allocated
+     */
+    uint32_t GetInUse() const;
+
+  private:
+    static constexpr uint32_t SLAB_ITEMS = 64; //!< Items per slab
+
+    std::vector<std::unique_ptr<TcpTxItem[]>> m_slabs; //!< The slabs
+    TcpTxItem* m_free{nullptr};                        //!< Free list, through m_link.next
+    uint32_t m_inUse{0};                               //!< Items currently allocated
 };
 
 } // namespace ns3
@@ -146,7 +146,7 @@ TcpGeneralTest::DoRun()
     senderDev->GetQueue()->TraceConnect("Drop",
                                         "SENDER",
                                         MakeCallback(&TcpGeneralTest::QueueDropCb, this));
-    senderDev->TraceConnect("PhyRxDrop", "sender", MakeCallback(&TcpGeneralTest::PhyDropCb, this));
+    senderDev->TraceConnect("PhyRxDrop", "SENDER", MakeCallback(&TcpGeneralTest::PhyDropCb, this));
 
     receiverDev->SetMtu(m_mtu);
     receiverDev->GetQueue()->TraceConnect("Drop",
@@ -833,6 +833,40 @@ TcpGeneralTest::GetPersistentEvent(SocketWho who)
     }
 }
 
+EventId
+TcpGeneralTest::GetRackTimer(SocketWho who)
+{
+    if (who == SENDER)
+    {
+        return DynamicCast<TcpSocketMsgBase>(m_senderSocket)->m_rackTimer;
+    }
+    else if (who == RECEIVER)
+    {
+        return DynamicCast<TcpSocketMsgBase>(m_receiverSocket)->m_rackTimer;
+    }
+    else
+    {
+        NS_FATAL_ERROR("Not defined");
+    }
+}
+
+bool
+TcpGeneralTest::GetRecoverActive(SocketWho who)
+{
+    if (who == SENDER)
+    {
+        return DynamicCast<TcpSocketMsgBase>(m_senderSocket)->m_recoverActive;
+    }
+    else if (who == RECEIVER)
+    {
+        return DynamicCast<TcpSocketMsgBase>(m_receiverSocket)->m_recoverActive;
+    }
+    else
+    {
+        NS_FATAL_ERROR("Not defined");
+    }
+}
+
 Time
 TcpGeneralTest::GetPersistentTimeout(SocketWho who)
 {
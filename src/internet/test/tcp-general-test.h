@@ -548,6 +548,22 @@ class TcpGeneralTest : public TestCase
      */
     EventId GetPersistentEvent(SocketWho who);
 
+    /**
+     * @brief Get the RACK reordering timer of the selected socket
+     *
+     * @param who socket where check the parameter
+     * @return the RACK reordering timer in the selected socket
+     */
+    EventId GetRackTimer(SocketWho who);
+
+    /**
+     * @brief Check if the recovery point of the selected socket is active
+     *
+     * @param who socket where check the parameter
+     * @return true if no new recovery may start before the recovery point is ACKed
+     */
+    bool GetRecoverActive(SocketWho who);
+
     /**
      * @brief Get the persistent timeout of the selected socket
      *
@@ -0,0 +1,285 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "tcp-error-model.h"
+#include "tcp-general-test.h"
+
+#include "ns3/log.h"
+#include "ns3/node.h"
+
+#include <map>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("TcpGroTest");
+
+/**
+ * @ingroup internet-test
+ * @ingroup tests
+ *
+ * @brief Check the receive aggregation (GRO) of TcpSocketBase
+ *
+ * The sender uses TSO, so that bursts of segments reach the receiver at the
+ * same time. With GRO, the receiver merges each burst and ACKs it once:
+ * it sends far fewer ACKs than one every DelAckCount segments. A segment
+ * lost in a burst is still SACKed at once, and all the data is delivered.
+ */
+class TcpGroTest : public TcpGeneralTest
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param gro Boolean value to enable or disable GRO.
+     * @param seqToKill Sequence number of the segment to drop, 0 for none.
+     * @param msg Test message.
+     */
+    TcpGroTest(bool gro, uint32_t seqToKill, const std::string& msg);
+
+  protected:
+    Ptr<ErrorModel> CreateReceiverErrorModel() override;
+    Ptr<TcpSocketMsgBase> CreateSenderSocket(Ptr<Node> node) override;
+    Ptr<TcpSocketMsgBase> CreateReceiverSocket(Ptr<Node> node) override;
+    void ConfigureProperties() override;
+    void ConfigureEnvironment() override;
+    void Tx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who) override;
+    void Rx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who) override;
+    void FinalChecks() override;
+
+    bool m_gro;                   //!< Enable/Disable GRO.
+    uint32_t m_seqToKill;         //!< Sequence number to drop, 0 for none.
+    uint32_t m_acks{0};           //!< ACKs of in-order data sent by the receiver.
+    bool m_sacked{false};         //!< The receiver sent a SACK block.
+    SequenceNumber32 m_rxHigh{0}; //!< Highest sequence number received, plus one.
+};
+
+TcpGroTest::TcpGroTest(bool gro, uint32_t seqToKill, const std::string& msg)
+    : TcpGeneralTest(msg),
+      m_gro(gro),
+      m_seqToKill(seqToKill)
+{
+}
+
+void
+TcpGroTest::ConfigureProperties()
+{
+    TcpGeneralTest::ConfigureProperties();
+    SetInitialCwnd(SENDER, 10);
+}
+
+void
+TcpGroTest::ConfigureEnvironment()
+{
+    TcpGeneralTest::ConfigureEnvironment();
+    SetAppPktCount(100);
+    SetAppPktInterval(MicroSeconds(10));
+}
+
+Ptr<ErrorModel>
+TcpGroTest::CreateReceiverErrorModel()
+{
+    if (m_seqToKill == 0)
+    {
+        return nullptr;
+    }
+    Ptr<TcpSeqErrorModel> errorModel = CreateObject<TcpSeqErrorModel>();
+    errorModel->AddSeqToKill(SequenceNumber32(m_seqToKill));
+    return errorModel;
+}
+
+Ptr<TcpSocketMsgBase>
+TcpGroTest::CreateSenderSocket(Ptr<Node> node)
+{
+    Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateSenderSocket(node);
+    socket->SetAttribute("Tso", BooleanValue(true));
+    socket->SetAttribute("TsoMaxSegments", UintegerValue(8));
+    return socket;
+}
+
+Ptr<TcpSocketMsgBase>
+TcpGroTest::CreateReceiverSocket(Ptr<Node> node)
+{
+    Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateReceiverSocket(node);
+    socket->SetAttribute("GroMaxSegments", UintegerValue(m_gro ? 8 : 1));
+    return socket;
+}
+
+void
+TcpGroTest::Tx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who)
+{
+    if (who == RECEIVER && p->GetSize() == 0 && (h.GetFlags() & TcpHeader::ACK) &&
+        !(h.GetFlags() & (TcpHeader::SYN | TcpHeader::FIN)))
+    {
+        // The out-of-order segments are not merged, and ACKed one by one
+        if (h.HasOption(TcpOption::SACK))
+        {
+            m_sacked = true;
+        }
+        else
+        {
+            m_acks++;
+        }
+    }
+}
+
+void
+TcpGroTest::Rx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who)
+{
+    // Only the data: the ACK of the FIN of the receiver is past the FIN
+    if (who == RECEIVER && p->GetSize() > 0)
+    {
+        m_rxHigh = std::max(m_rxHigh, h.GetSequenceNumber() + SequenceNumber32(p->GetSize()));
+    }
+}
+
+void
+TcpGroTest::FinalChecks()
+{
+    uint32_t segments = GetPktCount() * GetPktSize() / GetSegSize(SENDER);
+    if (m_gro)
+    {
+        NS_TEST_ASSERT_MSG_LT(m_acks, segments / 2 - 10, "The bursts were not ACKed at once");
+    }
+    else
+    {
+        NS_TEST_ASSERT_MSG_GT_OR_EQ(m_acks, segments / 2, "Fewer ACKs than DelAckCount allows");
+    }
+    if (m_seqToKill != 0)
+    {
+        NS_TEST_ASSERT_MSG_EQ(m_sacked, true, "The hole was not SACKed");
+    }
+    NS_TEST_ASSERT_MSG_EQ(m_rxHigh.GetValue(),
+                          GetPktSize() * GetPktCount() + 1,
+                          "Not all the data was received");
+}
+
+/**
+ * @ingroup internet-test
+ * @ingroup tests
+ *
+ * @brief Check the timestamps echoed by the receiver with GRO
+ *
+ * The segments are sent one by one, a fraction of a millisecond apart, so
+ * that the TSval changes in the middle of the stream and a segment with a
+ * new TSval ends the pending aggregate. As in RFC 7323, every ACK must echo
+ * the TSval of the segment starting at the previous ACK: the segment that
+ * ends an aggregate must find the aggregate already in the Rx buffer, or
+ * its TSval is not recorded.
+ */
+class TcpGroTimestampTest : public TcpGeneralTest
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param msg Test message.
+     */
+    TcpGroTimestampTest(const std::string& msg);
+
+  protected:
+    Ptr<TcpSocketMsgBase> CreateReceiverSocket(Ptr<Node> node) override;
+    void ConfigureProperties() override;
+    void ConfigureEnvironment() override;
+    void Tx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who) override;
+    void Rx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who) override;
+    void FinalChecks() override;
+
+    std::map<SequenceNumber32, uint32_t> m_tsValues; //!< TSval of the data, by sequence number.
+    SequenceNumber32 m_lastAck{0}; //!< Last acknowledgment number sent by the receiver.
+    uint32_t m_lastEcho{0};        //!< Last TSecr sent by the receiver.
+    uint32_t m_newEchoes{0};       //!< ACKs that had to echo a new TSval.
+};
+
+TcpGroTimestampTest::TcpGroTimestampTest(const std::string& msg)
+    : TcpGeneralTest(msg)
+{
+}
+
+void
+TcpGroTimestampTest::ConfigureProperties()
+{
+    TcpGeneralTest::ConfigureProperties();
+    SetInitialCwnd(SENDER, 10);
+}
+
+void
+TcpGroTimestampTest::ConfigureEnvironment()
+{
+    TcpGeneralTest::ConfigureEnvironment();
+    SetAppPktCount(100);
+    SetAppPktInterval(MicroSeconds(300));
+}
+
+Ptr<TcpSocketMsgBase>
+TcpGroTimestampTest::CreateReceiverSocket(Ptr<Node> node)
+{
+    Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateReceiverSocket(node);
+    socket->SetAttribute("GroMaxSegments", UintegerValue(8));
+    socket->SetAttribute("GroFlushTimeout", TimeValue(MilliSeconds(2)));
+    return socket;
+}
+
+void
+TcpGroTimestampTest::Rx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who)
+{
+    if (who == RECEIVER && p->GetSize() > 0 && h.GetParsedOptions().Has(TcpOption::TS))
+    {
+        m_tsValues[h.GetSequenceNumber()] = h.GetParsedOptions().tsValue;
+    }
+}
+
+void
+TcpGroTimestampTest::Tx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who)
+{
+    if (who != RECEIVER || !(h.GetFlags() & TcpHeader::ACK) ||
+        !h.GetParsedOptions().Has(TcpOption::TS))
+    {
+        return;
+    }
+    uint32_t echo = h.GetParsedOptions().tsEcho;
+    auto it = m_tsValues.find(m_lastAck);
+    if (p->GetSize() == 0 && h.GetAckNumber() > m_lastAck && it != m_tsValues.end())
+    {
+        NS_TEST_ASSERT_MSG_EQ(echo,
+                              it->second,
+                              "ACK of " << h.GetAckNumber()
+                                        << " does not echo the TSval of the segment "
+                                        << m_lastAck);
+        if (echo != m_lastEcho)
+        {
+            m_newEchoes++;
+        }
+    }
+    m_lastAck = std::max(m_lastAck, h.GetAckNumber());
+    m_lastEcho = echo;
+}
+
+void
+TcpGroTimestampTest::FinalChecks()
+{
+    NS_TEST_ASSERT_MSG_GT(m_newEchoes, 1, "The TSval never changed in the stream");
+}
+
+/**
+ * @ingroup internet-test
+ * @ingroup tests
+ *
+ * @brief Testsuite for the receive aggregation (GRO) of TcpSocketBase
+ */
+class TcpGroTestSuite : public TestSuite
+{
+  public:
+    TcpGroTestSuite()
+        : TestSuite("tcp-gro-test", Type::UNIT)
+    {
+        AddTestCase(new TcpGroTest(true, 0, "Bursts ACKed once with GRO"),
+                    TestCase::Duration::QUICK);
+        AddTestCase(new TcpGroTest(true, 10001, "Hole SACKed with GRO"),
+                    TestCase::Duration::QUICK);
+        AddTestCase(new TcpGroTest(false, 0, "One ACK every DelAckCount segments without GRO"),
+                    TestCase::Duration::QUICK);
+        AddTestCase(new TcpGroTimestampTest("TSval of the next segment echoed after a GRO flush"),
+                    TestCase::Duration::QUICK);
+    }
+};
+
+static TcpGroTestSuite g_tcpGroTestSuite; //!< Static variable for test initialization
@@ -13,6 +13,7 @@
 #include "ns3/log.h"
 #include "ns3/node.h"
 #include "ns3/simple-channel.h"
+#include "ns3/tcp-rack.h"
 #include "ns3/tcp-westwood-plus.h"
 
 using namespace ns3;
@@ -227,6 +228,405 @@ TcpRackTest::CWndTrace(uint32_t oldValue, uint32_t newValue)
     }
 }
 
+/**
+ * @ingroup internet-test
+ * @ingroup tests
+ *
+ * @brief Check the reordering window computed from the measured reordering
+ */
+class TcpRackAdaptiveReoWndTest : public TestCase
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param adaptive Boolean value to enable or disable AdaptiveReoWnd
+     * @param history Number of reordering samples kept
+     * @param expected Expected reordering window
+     * @param msg Test message.
+     */
+    TcpRackAdaptiveReoWndTest(bool adaptive,
+                              uint32_t history,
+                              Time expected,
+                              const std::string& msg);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * @brief Feed an RTT sample and three reordering samples, then update reo_wnd.
+     * @param rack the RACK state
+     */
+    void Sample(Ptr<TcpRack> rack);
+
+    /**
+     * @brief Count the reordering samples.
+     * @param extent reordering extent in time
+     * @param segments reordering extent in segments
+     */
+    void ReorderSample(Time extent, uint32_t segments);
+
+    bool m_adaptive;       //!< Enable/Disable AdaptiveReoWnd.
+    uint32_t m_history;    //!< Number of reordering samples kept.
+    Time m_expected;       //!< Expected reordering window.
+    uint32_t m_samples{0}; //!< Number of reordering samples traced.
+};
+
+TcpRackAdaptiveReoWndTest::TcpRackAdaptiveReoWndTest(bool adaptive,
+                                                     uint32_t history,
+                                                     Time expected,
+                                                     const std::string& msg)
+    : TestCase(msg),
+      m_adaptive(adaptive),
+      m_history(history),
+      m_expected(expected)
+{
+}
+
+void
+TcpRackAdaptiveReoWndTest::ReorderSample(Time extent, uint32_t segments)
+{
+    m_samples++;
+}
+
+void
+TcpRackAdaptiveReoWndTest::Sample(Ptr<TcpRack> rack)
+{
+    // RACK.rtt of 50 ms, measured at 100 ms
+    Ptr<TcpRttSampler> sampler = CreateObject<TcpRttSampler>();
+    sampler->SetEstimator(CreateObject<RttMeanDeviation>());
+    sampler->Subscribe(MakeCallback(&TcpRack::UpdateRtt, rack));
+    sampler->AddSample(MilliSeconds(50), MilliSeconds(50));
+    rack->UpdateStats(0,
+                      false,
+                      MilliSeconds(50),
+                      SequenceNumber32(10000),
+                      SequenceNumber32(20000),
+                      MilliSeconds(50));
+
+    // Segments delivered 10, 5 and 20 ms later than RACK.rtt
+    rack->SampleReordering(MilliSeconds(40), 2);
+    rack->SampleReordering(MilliSeconds(45), 1);
+    rack->SampleReordering(MilliSeconds(30), 3);
+
+    Ptr<TcpSocketState> tcb = CreateObject<TcpSocketState>();
+    rack->UpdateReoWnd(true,
+                       false,
+                       SequenceNumber32(20000),
+                       SequenceNumber32(5000),
+                       tcb,
+                       0,
+                       3,
+                       false);
+}
+
+void
+TcpRackAdaptiveReoWndTest::DoRun()
+{
+    Ptr<TcpRack> rack = CreateObject<TcpRack>();
+    rack->SetAttribute("AdaptiveReoWnd", BooleanValue(m_adaptive));
+    rack->SetAttribute("ReoWndPercentile", DoubleValue(0.5));
+    rack->SetAttribute("ReorderHistory", UintegerValue(m_history));
+    rack->TraceConnectWithoutContext(
+        "ReorderSample",
+        MakeCallback(&TcpRackAdaptiveReoWndTest::ReorderSample, this));
+
+    Simulator::Schedule(MilliSeconds(100), &TcpRackAdaptiveReoWndTest::Sample, this, rack);
+    Simulator::Run();
+    Simulator::Destroy();
+
+    NS_TEST_EXPECT_MSG_EQ(m_samples, 3, "Reordering samples not traced");
+    NS_TEST_EXPECT_MSG_EQ(rack->GetReoWnd(), m_expected, "Unexpected reordering window");
+    if (m_history >= 3)
+    {
+        NS_TEST_EXPECT_MSG_EQ(rack->GetReorderExtent(), MilliSeconds(10), "Wrong median extent");
+        NS_TEST_EXPECT_MSG_EQ(rack->GetReorderDegree(), 2, "Wrong median degree");
+    }
+}
+
+/**
+ * @ingroup internet-test
+ * @ingroup tests
+ *
+ * @brief Check that a retransmission lost during the recovery is found by RACK
+ *
+ * The segment is dropped twice: the original transmission and the fast
+ * retransmission. The second loss must be detected by RACK on the ACKs of
+ * the segments sent after the retransmission, not by the RTO.
+ */
+class TcpRackLostRetransmitTest : public TcpGeneralTest
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param seqToKill Sequence number of the packet to drop twice.
+     * @param msg Test message.
+     */
+    TcpRackLostRetransmitTest(uint32_t seqToKill, const std::string& msg);
+
+    Ptr<ErrorModel> CreateReceiverErrorModel() override;
+    Ptr<TcpSocketMsgBase> CreateSenderSocket(Ptr<Node> node) override;
+
+  protected:
+    void ConfigureProperties() override;
+    void ConfigureEnvironment() override;
+    void AfterRTOExpired(const Ptr<const TcpSocketState> tcb, SocketWho who) override;
+    void FinalChecks() override;
+
+    /**
+     * @brief Count the drops of the packet.
+     * @param ipH IPv4 header.
+     * @param tcpH TCP header.
+     * @param p The packet.
+     */
+    void PktDropped(const Ipv4Header& ipH, const TcpHeader& tcpH, Ptr<const Packet> p);
+
+    uint32_t m_seqToKill; //!< Sequence number to drop.
+    uint32_t m_drops{0};  //!< Number of drops of the packet.
+    uint32_t m_rtos{0};   //!< Number of RTO expirations.
+};
+
+TcpRackLostRetransmitTest::TcpRackLostRetransmitTest(uint32_t seqToKill, const std::string& msg)
+    : TcpGeneralTest(msg),
+      m_seqToKill(seqToKill)
+{
+}
+
+void
+TcpRackLostRetransmitTest::ConfigureProperties()
+{
+    TcpGeneralTest::ConfigureProperties();
+    SetSegmentSize(SENDER, 500);
+}
+
+void
+TcpRackLostRetransmitTest::ConfigureEnvironment()
+{
+    TcpGeneralTest::ConfigureEnvironment();
+    SetAppPktCount(200);
+}
+
+Ptr<ErrorModel>
+TcpRackLostRetransmitTest::CreateReceiverErrorModel()
+{
+    Ptr<TcpSeqErrorModel> errorModel = CreateObject<TcpSeqErrorModel>();
+    errorModel->AddSeqToKill(SequenceNumber32(m_seqToKill));
+    errorModel->AddSeqToKill(SequenceNumber32(m_seqToKill));
+    errorModel->SetDropCallback(MakeCallback(&TcpRackLostRetransmitTest::PktDropped, this));
+    return errorModel;
+}
+
+Ptr<TcpSocketMsgBase>
+TcpRackLostRetransmitTest::CreateSenderSocket(Ptr<Node> node)
+{
+    Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateSenderSocket(node);
+    socket->SetAttribute("MinRto", TimeValue(Seconds(10.0)));
+    socket->SetAttribute("Sack", BooleanValue(true));
+    socket->SetAttribute("Rack", BooleanValue(true));
+    return socket;
+}
+
+void
+TcpRackLostRetransmitTest::PktDropped(const Ipv4Header& ipH,
+                                      const TcpHeader& tcpH,
+                                      Ptr<const Packet> p)
+{
+    NS_LOG_FUNCTION(this << ipH << tcpH);
+    m_drops++;
+}
+
+void
+TcpRackLostRetransmitTest::AfterRTOExpired(const Ptr<const TcpSocketState> tcb, SocketWho who)
+{
+    m_rtos++;
+}
+
+void
+TcpRackLostRetransmitTest::FinalChecks()
+{
+    NS_TEST_ASSERT_MSG_EQ(m_drops, 2, "The packet and its retransmission should be dropped");
+    NS_TEST_ASSERT_MSG_EQ(m_rtos, 0, "Lost retransmission recovered by the RTO, not by RACK");
+}
+
+/**
+ * @ingroup internet-test
+ * @ingroup tests
+ *
+ * @brief Check the single RACK reordering timer
+ *
+ * A segment is dropped in the middle of a flight, and the SACKs of the
+ * segments that follow it arrive back to back. Once RACK finds the segment
+ * inside the reordering window, every SACK must move the one pending timer
+ * to the deadline reported by the RackTimer trace. With a high duplicate
+ * threshold the timer expires and the segment is retransmitted at the
+ * traced deadline; with the default one, the third SACK marks the segment
+ * as lost before the deadline, and the timer must be cancelled.
+ */
+class TcpRackTimerTest : public TcpGeneralTest
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param retxThresh Duplicate threshold of the sender.
+     * @param expire Whether the timer is expected to expire.
+     * @param msg Test message.
+     */
+    TcpRackTimerTest(uint32_t retxThresh, bool expire, const std::string& msg);
+
+    Ptr<ErrorModel> CreateReceiverErrorModel() override;
+    Ptr<TcpSocketMsgBase> CreateSenderSocket(Ptr<Node> node) override;
+
+  protected:
+    void ConfigureProperties() override;
+    void ConfigureEnvironment() override;
+    void Tx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who) override;
+    void AfterRTOExpired(const Ptr<const TcpSocketState> tcb, SocketWho who) override;
+    void FinalChecks() override;
+
+    /**
+     * @brief Check the timer every time it is (re)armed.
+     * @param expiry The expiration time reported by the trace.
+     */
+    void RackTimerTrace(Time expiry);
+
+    /**
+     * @brief Check that no timer is pending once the segment is retransmitted.
+     */
+    void CheckTimerStopped();
+
+    uint32_t m_retxThresh; //!< Duplicate threshold of the sender.
+    bool m_expire;         //!< Whether the timer is expected to expire.
+    EventId m_lastTimer;   //!< The timer armed when the trace last fired.
+    Time m_lastExpiry;     //!< The expiration time of the last timer.
+    uint32_t m_armed{0};   //!< Number of times the timer was armed.
+    uint32_t m_rearmed{0}; //!< Number of times a pending timer was moved.
+    Time m_retransmitted;  //!< Time of the retransmission of the dropped segment.
+    uint32_t m_rtos{0};    //!< Number of RTO expirations.
+
+    static constexpr uint32_t SEQ_TO_KILL = 5001; //!< Sequence number to drop.
+};
+
+TcpRackTimerTest::TcpRackTimerTest(uint32_t retxThresh, bool expire, const std::string& msg)
+    : TcpGeneralTest(msg),
+      m_retxThresh(retxThresh),
+      m_expire(expire),
+      m_retransmitted(Time::Max())
+{
+}
+
+void
+TcpRackTimerTest::ConfigureProperties()
+{
+    TcpGeneralTest::ConfigureProperties();
+    SetSegmentSize(SENDER, 500);
+    // One ACK per segment: the four segments sent after the dropped one are
+    // SACKed back to back
+    SetDelAckMaxCount(RECEIVER, 1);
+}
+
+void
+TcpRackTimerTest::ConfigureEnvironment()
+{
+    TcpGeneralTest::ConfigureEnvironment();
+    SetAppPktCount(20);
+}
+
+Ptr<ErrorModel>
+TcpRackTimerTest::CreateReceiverErrorModel()
+{
+    Ptr<TcpSeqErrorModel> errorModel = CreateObject<TcpSeqErrorModel>();
+    errorModel->AddSeqToKill(SequenceNumber32(SEQ_TO_KILL));
+    return errorModel;
+}
+
+Ptr<TcpSocketMsgBase>
+TcpRackTimerTest::CreateSenderSocket(Ptr<Node> node)
+{
+    Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateSenderSocket(node);
+    socket->SetAttribute("MinRto", TimeValue(Seconds(10.0)));
+    socket->SetAttribute("Sack", BooleanValue(true));
+    socket->SetAttribute("Rack", BooleanValue(true));
+    socket->SetAttribute("ReTxThreshold", UintegerValue(m_retxThresh));
+    socket->TraceConnectWithoutContext("RackTimer",
+                                       MakeCallback(&TcpRackTimerTest::RackTimerTrace, this));
+    return socket;
+}
+
+void
+TcpRackTimerTest::RackTimerTrace(Time expiry)
+{
+    NS_LOG_FUNCTION(this << expiry);
+    EventId timer = GetRackTimer(SENDER);
+
+    NS_TEST_ASSERT_MSG_GT(expiry, Simulator::Now(), "The timer expires in the past");
+    NS_TEST_ASSERT_MSG_EQ(timer.IsPending(), true, "The trace fired without arming the timer");
+    NS_TEST_ASSERT_MSG_EQ(timer.GetTs(),
+                          static_cast<uint64_t>(expiry.GetTimeStep()),
+                          "The trace reports a different expiration time");
+    if (m_armed > 0)
+    {
+        NS_TEST_ASSERT_MSG_NE(timer.GetUid(), m_lastTimer.GetUid(), "The timer was not re-armed");
+        NS_TEST_ASSERT_MSG_EQ(m_lastTimer.IsPending(),
+                              false,
+                              "The previous timer is still pending after the re-arm");
+        if (m_lastExpiry > Simulator::Now())
+        {
+            m_rearmed++;
+        }
+    }
+    m_lastTimer = timer;
+    m_lastExpiry = expiry;
+    m_armed++;
+}
+
+void
+TcpRackTimerTest::Tx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who)
+{
+    if (who != SENDER || h.GetSequenceNumber() != SequenceNumber32(SEQ_TO_KILL) ||
+        p->GetSize() == 0 || m_armed == 0 || m_retransmitted != Time::Max())
+    {
+        return;
+    }
+
+    m_retransmitted = Simulator::Now();
+    // The retransmission is sent while the ACK that found the loss is processed
+    Simulator::ScheduleNow(&TcpRackTimerTest::CheckTimerStopped, this);
+}
+
+void
+TcpRackTimerTest::CheckTimerStopped()
+{
+    NS_TEST_ASSERT_MSG_EQ(GetRackTimer(SENDER).IsPending(),
+                          false,
+                          "The timer is still pending after the loss was detected");
+}
+
+void
+TcpRackTimerTest::AfterRTOExpired(const Ptr<const TcpSocketState> tcb, SocketWho who)
+{
+    m_rtos++;
+}
+
+void
+TcpRackTimerTest::FinalChecks()
+{
+    NS_TEST_ASSERT_MSG_GT(m_armed, 0, "The timer was never armed");
+    NS_TEST_ASSERT_MSG_EQ(m_rtos, 0, "The segment was recovered by the RTO");
+    NS_TEST_ASSERT_MSG_EQ(GetRackTimer(SENDER).IsPending(), false, "A timer is left pending");
+    if (m_expire)
+    {
+        NS_TEST_ASSERT_MSG_GT(m_rearmed, 0, "The pending timer was never moved");
+        NS_TEST_ASSERT_MSG_EQ(m_retransmitted,
+                              m_lastExpiry,
+                              "The segment was not retransmitted when the timer expired");
+    }
+    else
+    {
+        NS_TEST_ASSERT_MSG_LT(m_retransmitted,
+                              m_lastExpiry,
+                              "The segment was not retransmitted before the timer expired");
+    }
+}
+
 /**
  * @ingroup internet-test
  * @ingroup tests
@@ -246,6 +646,30 @@ class TcpRackTestSuite : public TestSuite
                     TestCase::Duration::QUICK);
         AddTestCase(new TcpRackTest(TcpNewReno::GetTypeId(), 48501, false, "Rack Disabled testing"),
                     TestCase::Duration::QUICK);
+
+        AddTestCase(new TcpRackAdaptiveReoWndTest(false,
+                                                  64,
+                                                  MilliSeconds(50) / 4,
+                                                  "Fixed reo_wnd is a quarter of min_RTT"),
+                    TestCase::Duration::QUICK);
+        AddTestCase(new TcpRackAdaptiveReoWndTest(true,
+                                                  64,
+                                                  MilliSeconds(10),
+                                                  "Adaptive reo_wnd is the median extent"),
+                    TestCase::Duration::QUICK);
+        AddTestCase(new TcpRackAdaptiveReoWndTest(true,
+                                                  2,
+                                                  MilliSeconds(5),
+                                                  "Adaptive reo_wnd forgets old samples"),
+                    TestCase::Duration::QUICK);
+
+        AddTestCase(new TcpRackLostRetransmitTest(10001, "Lost retransmission found by RACK"),
+                    TestCase::Duration::QUICK);
+
+        AddTestCase(new TcpRackTimerTest(5, true, "RACK timer re-armed and expired"),
+                    TestCase::Duration::QUICK);
+        AddTestCase(new TcpRackTimerTest(3, false, "RACK timer cancelled on loss"),
+                    TestCase::Duration::QUICK);
     }
 };
 
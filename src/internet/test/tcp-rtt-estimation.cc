@@ -11,6 +11,8 @@
 #include "ns3/log.h"
 #include "ns3/node.h"
 #include "ns3/rtt-estimator.h"
+#include "ns3/simple-channel.h"
+#include "ns3/tcp-rtt-sampler.h"
 
 using namespace ns3;
 
@@ -25,6 +27,9 @@ NS_LOG_COMPONENT_DEFINE("TcpRttEstimationTestSuite");
  * The second check is that, when updating RTT history, we should consider
  * retransmission only segments which sequence number is lower than the highest
  * already transmitted.
+ * The third check is that the min RTT of the socket state is the minimum of
+ * the smoothed RTT, while its windowed min RTT, computed on the raw samples,
+ * is never above it.
  */
 class TcpRttEstimationTest : public TcpGeneralTest
 {
@@ -48,6 +53,9 @@ class TcpRttEstimationTest : public TcpGeneralTest
                            bool isRetransmission,
                            SocketWho who) override;
     void RttTrace(Time oldTime, Time newTime) override;
+    void ProcessedAck(const Ptr<const TcpSocketState> tcb,
+                      const TcpHeader& h,
+                      SocketWho who) override;
     void FinalChecks() override;
 
     void ConfigureEnvironment() override;
@@ -58,6 +66,7 @@ class TcpRttEstimationTest : public TcpGeneralTest
     SequenceNumber32 m_highestTxSeq; //!< Highest sequence number sent.
     uint32_t m_pktCount;             //!< Packet counter.
     uint32_t m_dataCount;            //!< Data counter.
+    Time m_minSrtt{Time::Max()};     //!< Minimum smoothed RTT.
 };
 
 TcpRttEstimationTest::TcpRttEstimationTest(const std::string& desc,
@@ -170,6 +179,21 @@ TcpRttEstimationTest::RttTrace(Time oldTime, Time newTime)
 {
     NS_LOG_DEBUG("Rtt changed to " << newTime.GetSeconds());
     m_rttChanged = true;
+    m_minSrtt = std::min(m_minSrtt, newTime);
+}
+
+void
+TcpRttEstimationTest::ProcessedAck(const Ptr<const TcpSocketState> tcb,
+                                   const TcpHeader& h,
+                                   SocketWho who)
+{
+    if (who == SENDER)
+    {
+        NS_TEST_ASSERT_MSG_EQ(tcb->m_minRtt, m_minSrtt, "min RTT is not the minimum srtt");
+        NS_TEST_ASSERT_MSG_LT_OR_EQ(tcb->m_windowedMinRtt,
+                                    tcb->m_minRtt,
+                                    "Windowed min RTT above the minimum srtt");
+    }
 }
 
 void
@@ -229,6 +253,174 @@ TcpRttEstimationWithLossTest::CreateReceiverErrorModel()
     return errorModel;
 }
 
+/**
+ * @ingroup internet-test
+ *
+ * @brief Check the min RTT fields when the RTT drops for a short time
+ *
+ * For a few milliseconds the channel delay falls to a tenth: the few
+ * samples taken meanwhile lower the windowed min RTT, but move the smoothed
+ * RTT, and hence the min RTT of the socket state, only by a fraction.
+ *
+ * @see TcpRttEstimationTest
+ */
+class TcpRttEstimationDelayDipTest : public TcpRttEstimationTest
+{
+  public:
+    /**
+     * @brief Constructor.
+     * @param desc Test description.
+     */
+    TcpRttEstimationDelayDipTest(const std::string& desc);
+
+  protected:
+    Ptr<SimpleChannel> CreateChannel() override;
+    void FinalChecks() override;
+
+  private:
+    /**
+     * @brief Set the delay of the channel.
+     * @param delay the new delay
+     */
+    void SetChannelDelay(Time delay);
+
+    Ptr<SimpleChannel> m_channel; //!< The channel.
+};
+
+TcpRttEstimationDelayDipTest::TcpRttEstimationDelayDipTest(const std::string& desc)
+    : TcpRttEstimationTest(desc, true, 100)
+{
+}
+
+Ptr<SimpleChannel>
+TcpRttEstimationDelayDipTest::CreateChannel()
+{
+    m_channel = TcpRttEstimationTest::CreateChannel();
+    Simulator::Schedule(MilliSeconds(2350),
+                        &TcpRttEstimationDelayDipTest::SetChannelDelay,
+                        this,
+                        MilliSeconds(5));
+    Simulator::Schedule(MilliSeconds(2360),
+                        &TcpRttEstimationDelayDipTest::SetChannelDelay,
+                        this,
+                        MilliSeconds(50));
+    return m_channel;
+}
+
+void
+TcpRttEstimationDelayDipTest::SetChannelDelay(Time delay)
+{
+    m_channel->SetAttribute("Delay", TimeValue(delay));
+}
+
+void
+TcpRttEstimationDelayDipTest::FinalChecks()
+{
+    TcpRttEstimationTest::FinalChecks();
+    Ptr<TcpSocketState> tcb = GetTcb(SENDER);
+    NS_LOG_DEBUG("min RTT " << tcb->m_minRtt << " windowed " << tcb->m_windowedMinRtt);
+    NS_TEST_ASSERT_MSG_LT(tcb->m_windowedMinRtt,
+                          tcb->m_minRtt,
+                          "The short dip did not lower only the windowed min RTT");
+}
+
+/**
+ * @ingroup internet-test
+ *
+ * @brief Check the RTT sampling service shared by RACK, TLP and the RTO
+ *
+ * The smoothed values must be those of the RttEstimator, min_rtt must be
+ * the minimum sample of the last MinRttWindow, and an ACK without a valid
+ * sample must only update the latest RTT.
+ */
+class TcpRttSamplerTest : public TestCase
+{
+  public:
+    TcpRttSamplerTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * @brief Record the sample handed to the subscribers.
+     * @param sample the RTT information
+     */
+    void Sampled(const TcpRttSample& sample);
+
+    /**
+     * @brief Add a sample and check the result.
+     * @param sampler the sampler
+     * @param rtt the RTT sample
+     * @param latestRtt the latest RTT
+     * @param minRtt the expected min_rtt
+     */
+    void Check(Ptr<TcpRttSampler> sampler, Time rtt, Time latestRtt, Time minRtt);
+
+    uint32_t m_notified{0}; //!< Number of samples handed to the subscriber
+    TcpRttSample m_last;    //!< Last sample handed to the subscriber
+};
+
+TcpRttSamplerTest::TcpRttSamplerTest()
+    : TestCase("RTT sampler: smoothed, windowed minimum and latest RTT")
+{
+}
+
+void
+TcpRttSamplerTest::Sampled(const TcpRttSample& sample)
+{
+    m_notified++;
+    m_last = sample;
+}
+
+void
+TcpRttSamplerTest::Check(Ptr<TcpRttSampler> sampler, Time rtt, Time latestRtt, Time minRtt)
+{
+    Ptr<RttEstimator> reference = sampler->GetEstimator()->Copy();
+    reference->Measurement(rtt);
+
+    sampler->AddSample(rtt, latestRtt);
+    NS_TEST_EXPECT_MSG_EQ(m_last.rtt, rtt, "Wrong sample");
+    NS_TEST_EXPECT_MSG_EQ(m_last.latestRtt, latestRtt, "Wrong latest RTT");
+    NS_TEST_EXPECT_MSG_EQ(m_last.srtt, reference->GetEstimate(), "srtt differs from estimator");
+    NS_TEST_EXPECT_MSG_EQ(m_last.rttVar, reference->GetVariation(), "Wrong rttvar");
+    NS_TEST_EXPECT_MSG_EQ(m_last.minRtt, minRtt, "Wrong min_rtt");
+}
+
+void
+TcpRttSamplerTest::DoRun()
+{
+    Ptr<TcpRttSampler> sampler = CreateObject<TcpRttSampler>();
+    sampler->SetAttribute("MinRttWindow", TimeValue(Seconds(10)));
+    sampler->SetEstimator(CreateObject<RttMeanDeviation>());
+    sampler->Subscribe(MakeCallback(&TcpRttSamplerTest::Sampled, this));
+
+    Check(sampler, MilliSeconds(100), MilliSeconds(100), MilliSeconds(100));
+    Check(sampler, MilliSeconds(80), MilliSeconds(90), MilliSeconds(80));
+    Check(sampler, MilliSeconds(120), MilliSeconds(120), MilliSeconds(80));
+    NS_TEST_EXPECT_MSG_EQ(m_notified, 3, "Subscriber not called on every sample");
+
+    // No valid sample (Karn): only the latest RTT changes
+    TcpRttSample before = sampler->GetSample();
+    sampler->AddSample(Time(0), MilliSeconds(150));
+    NS_TEST_EXPECT_MSG_EQ(m_notified, 4, "Subscriber not called");
+    NS_TEST_EXPECT_MSG_EQ(m_last.latestRtt, MilliSeconds(150), "Latest RTT not updated");
+    NS_TEST_EXPECT_MSG_EQ(m_last.srtt, before.srtt, "srtt updated without a sample");
+    NS_TEST_EXPECT_MSG_EQ(m_last.minRtt, before.minRtt, "min_rtt updated without a sample");
+    sampler->AddSample(Time(0), Time(0));
+    NS_TEST_EXPECT_MSG_EQ(m_notified, 4, "Subscriber called without information");
+
+    // Once the window has passed, the 80 ms minimum expires
+    Simulator::Schedule(Seconds(11), [this, sampler]() {
+        Check(sampler, MilliSeconds(110), MilliSeconds(110), MilliSeconds(110));
+    });
+    Simulator::Run();
+    Simulator::Destroy();
+
+    sampler->Reset();
+    NS_TEST_EXPECT_MSG_EQ(sampler->GetSample().minRtt, Time(0), "min_rtt not reset");
+    NS_TEST_EXPECT_MSG_EQ(sampler->GetEstimator()->GetNSamples(), 0, "Estimator not reset");
+}
+
 /**
  * @ingroup internet-test
  *
@@ -240,6 +432,7 @@ class TcpRttEstimationTestSuite : public TestSuite
     TcpRttEstimationTestSuite()
         : TestSuite("tcp-rtt-estimation-test", Type::UNIT)
     {
+        AddTestCase(new TcpRttSamplerTest(), TestCase::Duration::QUICK);
         AddTestCase(new TcpRttEstimationTest("RTT estimation, ts, no data", true, 0),
                     TestCase::Duration::QUICK);
         AddTestCase(new TcpRttEstimationTest("RTT estimation, no ts, no data", false, 0),
@@ -248,6 +441,8 @@ class TcpRttEstimationTestSuite : public TestSuite
                     TestCase::Duration::QUICK);
         AddTestCase(new TcpRttEstimationTest("RTT estimation, no ts, some data", false, 10),
                     TestCase::Duration::QUICK);
+        AddTestCase(new TcpRttEstimationDelayDipTest("RTT estimation, min RTT after a delay dip"),
+                    TestCase::Duration::QUICK);
 
         std::vector<uint32_t> toDrop;
         toDrop.push_back(501);
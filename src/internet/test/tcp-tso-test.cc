@@ -0,0 +1,199 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "tcp-error-model.h"
+#include "tcp-general-test.h"
+
+#include "ns3/log.h"
+#include "ns3/node.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("TcpTsoTest");
+
+/**
+ * @ingroup internet-test
+ * @ingroup tests
+ *
+ * @brief Check the super-segments (TSO/GSO) of TcpSocketBase
+ *
+ * With Tso enabled, the sender hands new data to the IP layer as
+ * super-segments; the SimpleNetDevice does not support segmentation
+ * offload, so the IP layer splits them and the receiver only sees
+ * full-sized segments. A segment lost in the middle of a super-segment is
+ * retransmitted alone, since the TxBuffer tracks the data at segment
+ * granularity.
+ */
+class TcpTsoTest : public TcpGeneralTest
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param tso Boolean value to enable or disable TSO.
+     * @param seqToKill Sequence number of the segment to drop, 0 for none.
+     * @param msg Test message.
+     */
+    TcpTsoTest(bool tso, uint32_t seqToKill, const std::string& msg);
+
+  protected:
+    Ptr<ErrorModel> CreateReceiverErrorModel() override;
+    Ptr<TcpSocketMsgBase> CreateSenderSocket(Ptr<Node> node) override;
+    void ConfigureProperties() override;
+    void ConfigureEnvironment() override;
+    void Tx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who) override;
+    void Rx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who) override;
+    void FinalChecks() override;
+
+    /**
+     * @brief Check the dropped segment.
+     * @param ipH IPv4 header.
+     * @param tcpH TCP header.
+     * @param p The packet.
+     */
+    void PktDropped(const Ipv4Header& ipH, const TcpHeader& tcpH, Ptr<const Packet> p);
+
+    bool m_tso;                   //!< Enable/Disable TSO.
+    uint32_t m_seqToKill;         //!< Sequence number to drop, 0 for none.
+    bool m_pktDropped{false};     //!< The segment has been dropped.
+    uint32_t m_superSegments{0};  //!< Super-segments sent.
+    uint32_t m_retransmits{0};    //!< Segments retransmitted.
+    SequenceNumber32 m_rxHigh{0}; //!< Highest sequence number received, plus one.
+};
+
+TcpTsoTest::TcpTsoTest(bool tso, uint32_t seqToKill, const std::string& msg)
+    : TcpGeneralTest(msg),
+      m_tso(tso),
+      m_seqToKill(seqToKill)
+{
+}
+
+void
+TcpTsoTest::ConfigureProperties()
+{
+    TcpGeneralTest::ConfigureProperties();
+    SetInitialCwnd(SENDER, 10);
+}
+
+void
+TcpTsoTest::ConfigureEnvironment()
+{
+    TcpGeneralTest::ConfigureEnvironment();
+    SetAppPktCount(100);
+}
+
+Ptr<ErrorModel>
+TcpTsoTest::CreateReceiverErrorModel()
+{
+    if (m_seqToKill == 0)
+    {
+        return nullptr;
+    }
+    Ptr<TcpSeqErrorModel> errorModel = CreateObject<TcpSeqErrorModel>();
+    errorModel->AddSeqToKill(SequenceNumber32(m_seqToKill));
+    errorModel->SetDropCallback(MakeCallback(&TcpTsoTest::PktDropped, this));
+    return errorModel;
+}
+
+Ptr<TcpSocketMsgBase>
+TcpTsoTest::CreateSenderSocket(Ptr<Node> node)
+{
+    Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateSenderSocket(node);
+    socket->SetAttribute("Sack", BooleanValue(true));
+    socket->SetAttribute("Tso", BooleanValue(m_tso));
+    socket->SetAttribute("TsoMaxSegments", UintegerValue(8));
+    return socket;
+}
+
+void
+TcpTsoTest::PktDropped(const Ipv4Header& ipH, const TcpHeader& tcpH, Ptr<const Packet> p)
+{
+    NS_LOG_FUNCTION(this << ipH << tcpH);
+    m_pktDropped = true;
+    NS_TEST_ASSERT_MSG_EQ(p->GetSize(), GetSegSize(SENDER), "A super-segment reached the wire");
+}
+
+void
+TcpTsoTest::Tx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who)
+{
+    if (who != SENDER || p->GetSize() == 0)
+    {
+        return;
+    }
+    if (p->GetSize() > GetSegSize(SENDER))
+    {
+        m_superSegments++;
+        NS_TEST_ASSERT_MSG_LT_OR_EQ(p->GetSize(),
+                                    8 * GetSegSize(SENDER),
+                                    "Super-segment larger than TsoMaxSegments");
+        NS_TEST_ASSERT_MSG_EQ(p->GetSize() % GetSegSize(SENDER),
+                              0,
+                              "Super-segment not made of full-sized segments");
+    }
+    if (h.GetSequenceNumber() < GetHighestTxMark(SENDER))
+    {
+        m_retransmits++;
+        NS_TEST_ASSERT_MSG_LT_OR_EQ(p->GetSize(),
+                                    GetSegSize(SENDER),
+                                    "Retransmission larger than a segment");
+    }
+}
+
+void
+TcpTsoTest::Rx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who)
+{
+    if (who != RECEIVER)
+    {
+        return;
+    }
+    NS_TEST_ASSERT_MSG_LT_OR_EQ(p->GetSize(), GetSegSize(SENDER), "Segment larger than the MSS");
+    // Only the data: the ACK of the FIN of the receiver is past the FIN
+    if (p->GetSize() > 0)
+    {
+        m_rxHigh = std::max(m_rxHigh, h.GetSequenceNumber() + SequenceNumber32(p->GetSize()));
+    }
+}
+
+void
+TcpTsoTest::FinalChecks()
+{
+    if (m_tso)
+    {
+        NS_TEST_ASSERT_MSG_GT(m_superSegments, 0, "No super-segment sent");
+    }
+    else
+    {
+        NS_TEST_ASSERT_MSG_EQ(m_superSegments, 0, "Super-segment sent while disabled");
+    }
+    if (m_seqToKill != 0)
+    {
+        NS_TEST_ASSERT_MSG_EQ(m_pktDropped, true, "The segment was not dropped");
+        NS_TEST_ASSERT_MSG_GT(m_retransmits, 0, "The lost segment was not retransmitted");
+    }
+    NS_TEST_ASSERT_MSG_EQ(m_rxHigh.GetValue(),
+                          GetPktSize() * GetPktCount() + 1,
+                          "Not all the data was received");
+}
+
+/**
+ * @ingroup internet-test
+ * @ingroup tests
+ *
+ * @brief Testsuite for the super-segments (TSO/GSO) of TcpSocketBase
+ */
+class TcpTsoTestSuite : public TestSuite
+{
+  public:
+    TcpTsoTestSuite()
+        : TestSuite("tcp-tso-test", Type::UNIT)
+    {
+        AddTestCase(new TcpTsoTest(true, 0, "Super-segments split before the wire"),
+                    TestCase::Duration::QUICK);
+        AddTestCase(new TcpTsoTest(true, 10001, "Segment lost inside a super-segment"),
+                    TestCase::Duration::QUICK);
+        AddTestCase(new TcpTsoTest(false, 0, "No super-segment without Tso"),
+                    TestCase::Duration::QUICK);
+    }
+};
+
+static TcpTsoTestSuite g_tcpTsoTestSuite; //!< Static variable for test initialization
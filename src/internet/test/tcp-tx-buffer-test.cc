@@ -42,6 +42,12 @@ class TcpTxBufferTestCase : public TestCase
     /** @brief Test the logic of merging items in GetTransmittedSegment()
      * which is triggered by CopyFromSequence()*/
     void TestMergeItemsWhenGetTransmittedSegment();
+    /** @brief Test that RACK walks the segments in transmission order */
+    void TestRackLoss();
+    /** @brief Test the scoreboard update with unordered and overlapping SACK blocks */
+    void TestUnorderedSackBlocks();
+    /** @brief Test the reuse of the items of the pool and the intrusive lists */
+    void TestItemPool();
     /**
      * @brief Callback to provide a value of receiver window
      * @returns the receiver window size
@@ -89,6 +95,27 @@ TcpTxBufferTestCase::DoRun()
                         &TcpTxBufferTestCase::TestMergeItemsWhenGetTransmittedSegment,
                         this);
 
+    /*
+     * Case for RACK loss detection:
+     *  -> a retransmitted head, sent after Rack.packet, does not prevent
+     *     the detection of the older segments that follow it in sequence
+     */
+    Simulator::Schedule(Seconds(0), &TcpTxBufferTestCase::TestRackLoss, this);
+
+    /*
+     * Case for the scoreboard update:
+     *  -> SACK blocks received out of order, overlapping, or not aligned to
+     *     the segment boundaries
+     */
+    Simulator::Schedule(Seconds(0), &TcpTxBufferTestCase::TestUnorderedSackBlocks, this);
+
+    /*
+     * Case for the item storage:
+     *  -> released items are reused, in a steady state nothing is allocated
+     *  -> an item can be linked in two lists at the same time
+     */
+    Simulator::Schedule(Seconds(0), &TcpTxBufferTestCase::TestItemPool, this);
+
     Simulator::Run();
     Simulator::Destroy();
 }
@@ -152,6 +179,62 @@ TcpTxBufferTestCase::TestIsLost()
     }
 }
 
+void
+TcpTxBufferTestCase::TestItemPool()
+{
+    TcpTxItemPool pool;
+    std::vector<TcpTxItem*> items;
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        items.push_back(pool.Allocate());
+    }
+    NS_TEST_ASSERT_MSG_EQ(pool.GetInUse(), 100, "Wrong number of items in use");
+    uint32_t slabs = pool.GetSlabs();
+
+    // Released items are reused before any new slab is allocated
+    for (uint32_t round = 0; round < 10; round++)
+    {
+        for (auto& item : items)
+        {
+            pool.Release(item);
+            item = pool.Allocate();
+            NS_TEST_ASSERT_MSG_EQ(item->GetPacket(), nullptr, "Reused item not reset");
+            NS_TEST_ASSERT_MSG_EQ(item->IsSacked(), false, "Reused item not reset");
+        }
+    }
+    NS_TEST_ASSERT_MSG_EQ(pool.GetSlabs(), slabs, "Slab allocated in steady state");
+
+    // The same items in two lists, in different orders
+    TcpTxItemList<&TcpTxItem::m_link> list;
+    TcpTxItemList<&TcpTxItem::m_tsortedLink> other;
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        list.push_back(items[i]);
+        other.push_front(items[i]);
+    }
+    NS_TEST_ASSERT_MSG_EQ(list.size(), 3, "Wrong list size");
+    NS_TEST_ASSERT_MSG_EQ(list.front(), items[0], "Wrong list order");
+    NS_TEST_ASSERT_MSG_EQ(other.front(), items[2], "Wrong list order");
+    NS_TEST_ASSERT_MSG_EQ(*(--list.end()), items[2], "Wrong list tail");
+
+    auto it = list.erase(list.iterator_to(items[1]));
+    NS_TEST_ASSERT_MSG_EQ(*it, items[2], "Wrong position after erase");
+    NS_TEST_ASSERT_MSG_EQ(other.size(), 3, "The other list changed");
+    list.insert(it, items[1]);
+    std::vector<TcpTxItem*> order(list.begin(), list.end());
+    NS_TEST_ASSERT_MSG_EQ((order == std::vector<TcpTxItem*>(items.begin(), items.begin() + 3)),
+                          true,
+                          "Wrong order after insert");
+
+    list.clear();
+    other.clear();
+    for (auto item : items)
+    {
+        pool.Release(item);
+    }
+    NS_TEST_ASSERT_MSG_EQ(pool.GetInUse(), 0, "Items not released");
+}
+
 uint32_t
 TcpTxBufferTestCase::GetRWnd() const
 {
@@ -409,6 +492,158 @@ TcpTxBufferTestCase::TestMergeItemsWhenGetTransmittedSegment()
     txBuf.CopyFromSequence(2000, SequenceNumber32(1));
 }
 
+void
+TcpTxBufferTestCase::TestRackLoss()
+{
+    Ptr<TcpTxBuffer> txBuf = CreateObject<TcpTxBuffer>();
+    txBuf->SetRWndCallback(MakeCallback(&TcpTxBufferTestCase::GetRWnd, this));
+    txBuf->SetHeadSequence(SequenceNumber32(1));
+    txBuf->SetSegmentSize(1000);
+    txBuf->SetDupAckThresh(3);
+    Ptr<TcpRack> rack = CreateObject<TcpRack>();
+    Ptr<TcpRttSampler> sampler = CreateObject<TcpRttSampler>();
+    sampler->SetEstimator(CreateObject<RttMeanDeviation>());
+    sampler->Subscribe(MakeCallback(&TcpRack::UpdateRtt, rack));
+
+    txBuf->Add(Create<Packet>(4000));
+
+    // Segments [1;1001) and [1001;2001) are sent at 0 ms
+    txBuf->CopyFromSequence(1000, SequenceNumber32(1));
+    txBuf->CopyFromSequence(1000, SequenceNumber32(1001));
+
+    // Segment [2001;3001) is sent at 5 ms
+    Simulator::Schedule(MilliSeconds(5), [txBuf]() {
+        txBuf->CopyFromSequence(1000, SequenceNumber32(2001));
+    });
+
+    // At 10 ms the head is retransmitted (e.g., by TLP), the last segment is
+    // sent, and the segment sent at 5 ms is SACKed
+    Simulator::Schedule(MilliSeconds(10), [this, txBuf, rack, sampler]() {
+        txBuf->CopyFromSequence(1000, SequenceNumber32(1));
+        txBuf->CopyFromSequence(1000, SequenceNumber32(3001));
+
+        Ptr<TcpOptionSack> sack = CreateObject<TcpOptionSack>();
+        sack->AddSackBlock(
+            TcpOptionSack::SackBlock(SequenceNumber32(2001), SequenceNumber32(3001)));
+        txBuf->Update(sack->GetSackList());
+        sampler->AddSample(MilliSeconds(5), MilliSeconds(5));
+        rack->UpdateStats(0,
+                          false,
+                          MilliSeconds(5),
+                          SequenceNumber32(3001),
+                          SequenceNumber32(4001),
+                          MilliSeconds(5));
+
+        Time timeout{0};
+        txBuf->DetectRackLoss(rack, &timeout);
+        NS_TEST_ASSERT_MSG_EQ(txBuf->GetLost(), 1000, "Only the segment sent at 0 ms is lost");
+        NS_TEST_ASSERT_MSG_EQ(txBuf->IsLost(SequenceNumber32(1001)), true, "Segment not lost");
+        NS_TEST_ASSERT_MSG_EQ(txBuf->IsLost(SequenceNumber32(1)),
+                              false,
+                              "Retransmitted head marked lost too early");
+        NS_TEST_ASSERT_MSG_EQ(txBuf->GetRetransmitsCount(), 1000, "Retransmission not counted");
+    });
+
+    // At 20 ms the last segment is SACKed, and reordering has been seen: the
+    // retransmission, sent at the same time but with a lower sequence number,
+    // is lost only after the reordering window (min_RTT / 4 = 1.25 ms)
+    Simulator::Schedule(MilliSeconds(20), [this, txBuf, rack, sampler]() {
+        Ptr<TcpOptionSack> sack = CreateObject<TcpOptionSack>();
+        sack->AddSackBlock(
+            TcpOptionSack::SackBlock(SequenceNumber32(3001), SequenceNumber32(4001)));
+        txBuf->Update(sack->GetSackList());
+        sampler->AddSample(MilliSeconds(10), MilliSeconds(10));
+        rack->UpdateStats(0,
+                          false,
+                          MilliSeconds(10),
+                          SequenceNumber32(4001),
+                          SequenceNumber32(4001),
+                          MilliSeconds(10));
+        rack->UpdateReoWnd(true,
+                           false,
+                           SequenceNumber32(4001),
+                           SequenceNumber32(1),
+                           CreateObject<TcpSocketState>(),
+                           txBuf->GetSacked(),
+                           3,
+                           false);
+        NS_TEST_ASSERT_MSG_EQ(rack->GetReoWnd(), MicroSeconds(1250), "Wrong reordering window");
+
+        Time timeout{0};
+        txBuf->DetectRackLoss(rack, &timeout);
+        NS_TEST_ASSERT_MSG_EQ(txBuf->GetLost(), 1000, "Retransmission lost too early");
+        NS_TEST_ASSERT_MSG_EQ(timeout, MicroSeconds(1250), "Wrong RACK timeout");
+
+        Simulator::Schedule(timeout, [this, txBuf, rack]() {
+            Time timeout{0};
+            txBuf->DetectRackLoss(rack, &timeout);
+            NS_TEST_ASSERT_MSG_EQ(txBuf->GetLost(), 2000, "Retransmission not detected as lost");
+            NS_TEST_ASSERT_MSG_EQ(timeout, Time(0), "No segment should be waiting");
+
+            txBuf->DiscardUpTo(SequenceNumber32(4001));
+            NS_TEST_ASSERT_MSG_EQ(txBuf->Size(), 0, "Data inside the buffer");
+        });
+    });
+}
+
+void
+TcpTxBufferTestCase::TestUnorderedSackBlocks()
+{
+    Ptr<TcpTxBuffer> txBuf = CreateObject<TcpTxBuffer>();
+    txBuf->SetRWndCallback(MakeCallback(&TcpTxBufferTestCase::GetRWnd, this));
+    txBuf->SetHeadSequence(SequenceNumber32(1));
+    txBuf->SetSegmentSize(1000);
+    txBuf->SetDupAckThresh(3);
+
+    txBuf->Add(Create<Packet>(10000));
+    for (uint8_t i = 0; i < 10; ++i)
+    {
+        txBuf->CopyFromSequence(1000, SequenceNumber32((i * 1000) + 1));
+    }
+
+    // Highest block first, then an overlapping one, and one not aligned to
+    // the segment boundaries (only [6001;7001) is entirely covered by it)
+    Ptr<TcpOptionSack> sack = CreateObject<TcpOptionSack>();
+    sack->AddSackBlock(TcpOptionSack::SackBlock(SequenceNumber32(8001), SequenceNumber32(10001)));
+    sack->AddSackBlock(TcpOptionSack::SackBlock(SequenceNumber32(3001), SequenceNumber32(5001)));
+    sack->AddSackBlock(TcpOptionSack::SackBlock(SequenceNumber32(4001), SequenceNumber32(5001)));
+    sack->AddSackBlock(TcpOptionSack::SackBlock(SequenceNumber32(5501), SequenceNumber32(7501)));
+
+    NS_TEST_ASSERT_MSG_EQ(txBuf->Update(sack->GetSackList()), 5000, "Wrong newly sacked bytes");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetSacked(), 5000, "Wrong sacked bytes");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetHighestSacked(), SequenceNumber32(9001), "Wrong highest SACK");
+
+    // Three segments are sacked above the first three
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsLost(SequenceNumber32(1)), true, "Head should be lost");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsLost(SequenceNumber32(2500)), true, "Segment should be lost");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsLost(SequenceNumber32(3001)), false, "Sacked, not lost");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsLost(SequenceNumber32(9500)), false, "Above the highest SACK");
+
+    // The same option again does not sack anything new
+    NS_TEST_ASSERT_MSG_EQ(txBuf->Update(sack->GetSackList()), 0, "Duplicated SACK counted");
+
+    TcpTxItem item;
+    txBuf->GetPacketInfo(SequenceNumber32(3001), &item);
+    NS_TEST_ASSERT_MSG_EQ(item.GetSeqSize(), 1000, "Item ending at 3001 not found");
+    NS_TEST_ASSERT_MSG_EQ(item.IsSacked(), false, "Item ending at 3001 is not sacked");
+
+    txBuf->DiscardUpTo(SequenceNumber32(2501));
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsLost(SequenceNumber32(2501)),
+                          true,
+                          "Fragmented head should be lost");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsRetransmittedDataAcked(SequenceNumber32(3001)),
+                          false,
+                          "Head has not been retransmitted");
+
+    txBuf->CopyFromSequence(500, SequenceNumber32(2501));
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsRetransmittedDataAcked(SequenceNumber32(3001)),
+                          true,
+                          "Head has been retransmitted");
+
+    txBuf->DiscardUpTo(SequenceNumber32(10001));
+    NS_TEST_ASSERT_MSG_EQ(txBuf->Size(), 0, "Data inside the buffer");
+}
+
 void
 TcpTxBufferTestCase::TestTransmittedBlock()
 {
@@ -0,0 +1,434 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "tcp-error-model.h"
+#include "tcp-general-test.h"
+
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/simple-channel.h"
+#include "ns3/tcp-tx-buffer.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("TcpUndoTest");
+
+/**
+ * @ingroup internet-test
+ * @ingroup tests
+ *
+ * @brief Check the undo of a window reduction caused by a delay spike
+ *
+ * For a short time the channel delay is multiplied, so that the segments
+ * sent meanwhile arrive late: the sender retransmits them, by RTO or
+ * because the segments sent after the spike are SACKed first, although
+ * nothing was lost. The late ACKs (timestamps) and the DSACKs of the
+ * retransmissions prove the reduction spurious; with Undo enabled, the
+ * window is restored.
+ *
+ * A spike shorter than the RTO is recovered by fast retransmit: the late
+ * originals are then ACKed before the recovery point, and the undo must
+ * end the recovery by itself.
+ */
+class TcpUndoSpuriousTest : public TcpGeneralTest
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param undo Boolean value to enable or disable Undo.
+     * @param spike Channel delay during the spike.
+     * @param recovery Whether the undo is expected in CA_RECOVERY.
+     * @param msg Test message.
+     */
+    TcpUndoSpuriousTest(bool undo, Time spike, bool recovery, const std::string& msg);
+
+  protected:
+    Ptr<SimpleChannel> CreateChannel() override;
+    Ptr<TcpSocketMsgBase> CreateSenderSocket(Ptr<Node> node) override;
+    Ptr<TcpSocketMsgBase> CreateReceiverSocket(Ptr<Node> node) override;
+    void ConfigureEnvironment() override;
+    void Tx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who) override;
+    void Rx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who) override;
+    void CongStateTrace(const TcpSocketState::TcpCongState_t oldValue,
+                        const TcpSocketState::TcpCongState_t newValue) override;
+    void FinalChecks() override;
+
+    /**
+     * @brief Count the undo events.
+     * @param cWnd the restored cWnd
+     * @param ssThresh the restored ssThresh
+     */
+    void Undo(uint32_t cWnd, uint32_t ssThresh);
+
+    /**
+     * @brief Set the delay of the channel.
+     * @param delay the new delay
+     */
+    void SetChannelDelay(Time delay);
+
+    bool m_undo;                      //!< Enable/Disable Undo.
+    Time m_spike;                     //!< Channel delay during the spike.
+    bool m_recovery;                  //!< The undo is expected in CA_RECOVERY.
+    Ptr<SimpleChannel> m_channel;     //!< The channel.
+    uint32_t m_undos{0};              //!< Number of undo events.
+    uint32_t m_retransmits{0};        //!< Number of retransmitted segments.
+    uint32_t m_restoredCwnd{0};       //!< cWnd restored by the last undo.
+    uint32_t m_maxLost{0};            //!< Highest lost count seen at a retransmission.
+    uint32_t m_lostAtUndo{0};         //!< Highest lost count left by an undo.
+    uint32_t m_recoveryUndos{0};      //!< Undo events before the recovery point.
+    SequenceNumber32 m_lastAck;       //!< Last ACK number received by the sender.
+    SequenceNumber32 m_recoveryPoint; //!< Highest sequence sent when recovery began.
+    TcpSocketState::TcpCongState_t m_leftState{
+        TcpSocketState::CA_OPEN}; //!< Congestion state left by the last change.
+    Time m_leftTime;              //!< Time of the last congestion state change.
+};
+
+TcpUndoSpuriousTest::TcpUndoSpuriousTest(bool undo,
+                                         Time spike,
+                                         bool recovery,
+                                         const std::string& msg)
+    : TcpGeneralTest(msg),
+      m_undo(undo),
+      m_spike(spike),
+      m_recovery(recovery)
+{
+}
+
+void
+TcpUndoSpuriousTest::ConfigureEnvironment()
+{
+    TcpGeneralTest::ConfigureEnvironment();
+    SetAppPktCount(200);
+}
+
+Ptr<SimpleChannel>
+TcpUndoSpuriousTest::CreateChannel()
+{
+    m_channel = TcpGeneralTest::CreateChannel();
+
+    // The connection starts at 10 s with a 1 s RTT: the spike hits a window
+    // of a few tens of segments
+    Simulator::Schedule(Seconds(14.2),
+                        &TcpUndoSpuriousTest::SetChannelDelay,
+                        this,
+                        m_spike);
+    Simulator::Schedule(Seconds(14.25),
+                        &TcpUndoSpuriousTest::SetChannelDelay,
+                        this,
+                        MilliSeconds(500));
+    return m_channel;
+}
+
+void
+TcpUndoSpuriousTest::SetChannelDelay(Time delay)
+{
+    m_channel->SetAttribute("Delay", TimeValue(delay));
+}
+
+Ptr<TcpSocketMsgBase>
+TcpUndoSpuriousTest::CreateSenderSocket(Ptr<Node> node)
+{
+    Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateSenderSocket(node);
+    socket->SetAttribute("Sack", BooleanValue(true));
+    socket->SetAttribute("Dsack", BooleanValue(true));
+    socket->SetAttribute("Undo", BooleanValue(m_undo));
+    socket->TraceConnectWithoutContext("Undo", MakeCallback(&TcpUndoSpuriousTest::Undo, this));
+    return socket;
+}
+
+Ptr<TcpSocketMsgBase>
+TcpUndoSpuriousTest::CreateReceiverSocket(Ptr<Node> node)
+{
+    Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateReceiverSocket(node);
+    socket->SetAttribute("Sack", BooleanValue(true));
+    socket->SetAttribute("Dsack", BooleanValue(true));
+    return socket;
+}
+
+void
+TcpUndoSpuriousTest::Tx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who)
+{
+    if (who == SENDER && p->GetSize() > 0 && h.GetSequenceNumber() < GetHighestTxMark(SENDER))
+    {
+        m_retransmits++;
+        m_maxLost = std::max(m_maxLost, GetTxBuffer(SENDER)->GetLost());
+    }
+}
+
+void
+TcpUndoSpuriousTest::Rx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who)
+{
+    if (who == SENDER)
+    {
+        m_lastAck = h.GetAckNumber();
+    }
+}
+
+void
+TcpUndoSpuriousTest::CongStateTrace(const TcpSocketState::TcpCongState_t oldValue,
+                                    const TcpSocketState::TcpCongState_t newValue)
+{
+    if (newValue == TcpSocketState::CA_RECOVERY)
+    {
+        m_recoveryPoint = GetHighestTxMark(SENDER);
+    }
+    m_leftState = oldValue;
+    m_leftTime = Simulator::Now();
+}
+
+void
+TcpUndoSpuriousTest::Undo(uint32_t cWnd, uint32_t ssThresh)
+{
+    NS_LOG_FUNCTION(this << cWnd << ssThresh);
+    m_undos++;
+    m_restoredCwnd = cWnd;
+    m_lostAtUndo = std::max(m_lostAtUndo, GetTxBuffer(SENDER)->GetLost());
+
+    // Undone by an ACK below the recovery point: the undo itself ends the
+    // recovery, as the ACK of the recovery point would
+    if (m_leftState == TcpSocketState::CA_RECOVERY && m_leftTime == Simulator::Now() &&
+        m_lastAck < m_recoveryPoint)
+    {
+        m_recoveryUndos++;
+        NS_TEST_ASSERT_MSG_EQ(GetTcb(SENDER)->m_congState.Get(),
+                              TcpSocketState::CA_OPEN,
+                              "Undo did not leave the recovery");
+        NS_TEST_ASSERT_MSG_EQ(GetRecoverActive(SENDER),
+                              false,
+                              "Undo left the recovery point active");
+        NS_TEST_ASSERT_MSG_EQ(GetDupAckCount(SENDER), 0, "Undo left the dupack count set");
+        NS_TEST_ASSERT_MSG_EQ(GetRackTimer(SENDER).IsPending(),
+                              false,
+                              "Undo left the RACK timer running");
+    }
+}
+
+void
+TcpUndoSpuriousTest::FinalChecks()
+{
+    NS_TEST_ASSERT_MSG_GT(m_retransmits, 0, "The delay spike caused no retransmission");
+    if (m_undo)
+    {
+        NS_TEST_ASSERT_MSG_GT(m_undos, 0, "The spurious reduction was not undone");
+        NS_TEST_ASSERT_MSG_GT(m_restoredCwnd,
+                              GetSegSize(SENDER),
+                              "The undo did not restore the window");
+        NS_TEST_ASSERT_MSG_GT(m_maxLost, 0, "No segment was marked lost");
+        NS_TEST_ASSERT_MSG_EQ(m_lostAtUndo, 0, "The undo left segments marked lost");
+        if (m_recovery)
+        {
+            NS_TEST_ASSERT_MSG_GT(m_recoveryUndos, 0, "No undo before the recovery point");
+        }
+    }
+    else
+    {
+        NS_TEST_ASSERT_MSG_EQ(m_undos, 0, "Undo while disabled");
+    }
+}
+
+/**
+ * @ingroup internet-test
+ *
+ * @brief Error model which drops once the pure ACK of a given sequence.
+ */
+class TcpAckErrorModel : public TcpGeneralErrorModel
+{
+  public:
+    /**
+     * @brief Get the type ID.
+     * @return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * @brief Set the acknowledgment number of the ACK to drop
+     * @param ackToKill the acknowledgment number
+     */
+    void SetAckToKill(SequenceNumber32 ackToKill)
+    {
+        m_ackToKill = ackToKill;
+        m_killed = false;
+    }
+
+  protected:
+    bool ShouldDrop(const Ipv4Header& ipHeader,
+                    const TcpHeader& tcpHeader,
+                    uint32_t packetSize) override;
+
+  private:
+    void DoReset() override
+    {
+        m_killed = false;
+    }
+
+    SequenceNumber32 m_ackToKill; //!< Acknowledgment number of the ACK to drop.
+    bool m_killed{false};         //!< The ACK was already dropped.
+};
+
+NS_OBJECT_ENSURE_REGISTERED(TcpAckErrorModel);
+
+TypeId
+TcpAckErrorModel::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::TcpAckErrorModel").SetParent<TcpGeneralErrorModel>();
+    return tid;
+}
+
+bool
+TcpAckErrorModel::ShouldDrop(const Ipv4Header& ipHeader,
+                             const TcpHeader& tcpHeader,
+                             uint32_t packetSize)
+{
+    NS_LOG_FUNCTION(this << ipHeader << tcpHeader);
+
+    if (!m_killed && packetSize == 0 && (tcpHeader.GetFlags() & TcpHeader::ACK) &&
+        tcpHeader.GetAckNumber() == m_ackToKill)
+    {
+        NS_LOG_INFO("ACK of " << m_ackToKill << " dropped");
+        m_killed = true;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @ingroup internet-test
+ * @ingroup tests
+ *
+ * @brief Check the D-SACK of a duplicate segment ending at RCV.NXT
+ *
+ * The ACK of the first data segment is dropped, so the sender retransmits
+ * it by RTO. The retransmission ends exactly at RCV.NXT: it is not out of
+ * range, but the receiver must still report it with a D-SACK block
+ * (RFC 2883), which is what the undo engine of the sender counts.
+ */
+class TcpDsackDuplicateTest : public TcpGeneralTest
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param msg Test message.
+     */
+    TcpDsackDuplicateTest(const std::string& msg);
+
+  protected:
+    Ptr<ErrorModel> CreateSenderErrorModel() override;
+    Ptr<TcpSocketMsgBase> CreateSenderSocket(Ptr<Node> node) override;
+    Ptr<TcpSocketMsgBase> CreateReceiverSocket(Ptr<Node> node) override;
+    void ConfigureEnvironment() override;
+    void ConfigureProperties() override;
+    void Tx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who) override;
+    void FinalChecks() override;
+
+    Ptr<TcpAckErrorModel> m_errorModel; //!< Drops the ACK of the first segment.
+    bool m_retransmitted{false};         //!< The first segment was retransmitted.
+    uint32_t m_dsacks{0};                //!< D-SACK blocks of the first segment sent.
+};
+
+TcpDsackDuplicateTest::TcpDsackDuplicateTest(const std::string& msg)
+    : TcpGeneralTest(msg)
+{
+}
+
+void
+TcpDsackDuplicateTest::ConfigureEnvironment()
+{
+    TcpGeneralTest::ConfigureEnvironment();
+    SetAppPktCount(5);
+}
+
+void
+TcpDsackDuplicateTest::ConfigureProperties()
+{
+    TcpGeneralTest::ConfigureProperties();
+    SetInitialCwnd(SENDER, 1);
+    m_errorModel->SetAckToKill(SequenceNumber32(1 + GetSegSize(SENDER)));
+}
+
+Ptr<ErrorModel>
+TcpDsackDuplicateTest::CreateSenderErrorModel()
+{
+    m_errorModel = CreateObject<TcpAckErrorModel>();
+    return m_errorModel;
+}
+
+Ptr<TcpSocketMsgBase>
+TcpDsackDuplicateTest::CreateSenderSocket(Ptr<Node> node)
+{
+    Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateSenderSocket(node);
+    socket->SetAttribute("Sack", BooleanValue(true));
+    socket->SetAttribute("Dsack", BooleanValue(true));
+    return socket;
+}
+
+Ptr<TcpSocketMsgBase>
+TcpDsackDuplicateTest::CreateReceiverSocket(Ptr<Node> node)
+{
+    Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateReceiverSocket(node);
+    socket->SetAttribute("Sack", BooleanValue(true));
+    socket->SetAttribute("Dsack", BooleanValue(true));
+    return socket;
+}
+
+void
+TcpDsackDuplicateTest::Tx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who)
+{
+    if (who == SENDER && p->GetSize() > 0 && h.GetSequenceNumber() == SequenceNumber32(1) &&
+        GetHighestTxMark(SENDER) > SequenceNumber32(1))
+    {
+        m_retransmitted = true;
+    }
+    else if (who == RECEIVER && h.HasOption(TcpOption::SACK))
+    {
+        TcpOptionSack::SackList list =
+            DynamicCast<const TcpOptionSack>(h.GetOption(TcpOption::SACK))->GetSackList();
+        if (list.front().first == SequenceNumber32(1) &&
+            list.front().second == SequenceNumber32(1 + GetSegSize(SENDER)))
+        {
+            NS_TEST_ASSERT_MSG_EQ(h.GetAckNumber(),
+                                  list.front().second,
+                                  "The duplicate does not end at the cumulative ACK");
+            m_dsacks++;
+        }
+    }
+}
+
+void
+TcpDsackDuplicateTest::FinalChecks()
+{
+    NS_TEST_ASSERT_MSG_EQ(m_retransmitted, true, "The first segment was not retransmitted");
+    NS_TEST_ASSERT_MSG_EQ(m_dsacks, 1, "The duplicate was not reported by a D-SACK");
+}
+
+/**
+ * @ingroup internet-test
+ * @ingroup tests
+ *
+ * @brief Testsuite for the undo of spurious window reductions
+ */
+class TcpUndoTestSuite : public TestSuite
+{
+  public:
+    TcpUndoTestSuite()
+        : TestSuite("tcp-undo-test", Type::UNIT)
+    {
+        AddTestCase(
+            new TcpUndoSpuriousTest(true, MilliSeconds(2500), false, "Spurious reduction undone"),
+            TestCase::Duration::QUICK);
+        AddTestCase(new TcpUndoSpuriousTest(false,
+                                            MilliSeconds(2500),
+                                            false,
+                                            "Spurious reduction kept without Undo"),
+                    TestCase::Duration::QUICK);
+        AddTestCase(new TcpUndoSpuriousTest(true,
+                                            MilliSeconds(1500),
+                                            true,
+                                            "Spurious fast retransmit undone in CA_RECOVERY"),
+                    TestCase::Duration::QUICK);
+        AddTestCase(new TcpDsackDuplicateTest("D-SACK of a duplicate ending at RCV.NXT"),
+                    TestCase::Duration::QUICK);
+    }
+};
+
+static TcpUndoTestSuite g_tcpUndoTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,76 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+//
+// Converts a trace file written by ns3::BinaryTraceWriter to the text
+// format used by the .plotme files: one line per record, the time in
+// seconds followed by the values.
+//
+//     ./ns3 run "binary-trace-to-plotme --input=rack/example/Traces/cwnd.btrace
+//                --output=cwnd.plotme"
+//
+// With --column only the time and the named column are written. Without
+// --output the text goes to the standard output.
+//
+
+#include "ns3/binary-trace.h"
+#include "ns3/core-module.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("BinaryTraceToPlotme");
+
+int
+main(int argc, char* argv[])
+{
+    std::string input;
+    std::string output;
+    std::string column;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("input", "Binary trace file", input);
+    cmd.AddValue("output", "Text file to write (default: standard output)", output);
+    cmd.AddValue("column", "Only write this column", column);
+    cmd.Parse(argc, argv);
+
+    BinaryTraceReader reader(input);
+    NS_ABORT_MSG_UNLESS(reader.IsValid(), "Cannot read a binary trace from " << input);
+
+    const auto& columns = reader.GetColumns();
+    std::size_t first = 0;
+    std::size_t last = columns.size();
+    if (!column.empty())
+    {
+        auto it = std::find(columns.begin(), columns.end(), column);
+        NS_ABORT_MSG_IF(it == columns.end(), "No column " << column << " in " << input);
+        first = it - columns.begin();
+        last = first + 1;
+    }
+
+    std::ofstream file;
+    if (!output.empty())
+    {
+        file.open(output);
+        NS_ABORT_MSG_UNLESS(file.is_open(), "Unable to Open " << output);
+    }
+    std::ostream& os = output.empty() ? std::cout : file;
+
+    Time time;
+    std::vector<double> values;
+    while (reader.Read(time, values))
+    {
+        os << time.GetSeconds();
+        for (std::size_t i = first; i < last; i++)
+        {
+            os << " " << values[i];
+        }
+        os << "\n";
+    }
+    return 0;
+}
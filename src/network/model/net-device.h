@@ -356,6 +356,12 @@ class NetDevice : public Object
      * @return true if this interface supports a bridging mode, false otherwise.
      */
     virtual bool SupportsSendFrom() const = 0;
+
+    /**
+     * @return true if this interface splits the packets carrying a GsoTag
+     *         into segments itself, false otherwise.
+     */
+    virtual bool SupportsSegmentationOffload() const;
 };
 
 } // namespace ns3
@@ -0,0 +1,166 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/binary-trace.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <cmath>
+#include <fstream>
+#include <limits>
+
+using namespace ns3;
+
+/**
+ * @ingroup network-test
+ * @ingroup tests
+ *
+ * @brief BinaryTraceWriter / BinaryTraceReader round trip test.
+ */
+class BinaryTraceRoundTripTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     * @param compress delta code the trace
+     */
+    BinaryTraceRoundTripTestCase(bool compress);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Write one record stamped with the simulation time.
+     * @param writer the writer
+     * @param i the record number
+     */
+    void WriteRecord(Ptr<BinaryTraceWriter> writer, uint32_t i);
+
+    bool m_compress; //!< Delta code the trace
+};
+
+BinaryTraceRoundTripTestCase::BinaryTraceRoundTripTestCase(bool compress)
+    : TestCase(std::string("Binary trace round trip, ") +
+               (compress ? "compressed" : "uncompressed")),
+      m_compress(compress)
+{
+}
+
+void
+BinaryTraceRoundTripTestCase::WriteRecord(Ptr<BinaryTraceWriter> writer, uint32_t i)
+{
+    writer->Write({static_cast<double>(i * 524), i * 0.001 - 0.5});
+}
+
+void
+BinaryTraceRoundTripTestCase::DoRun()
+{
+    std::string filename = CreateTempDirFilename(m_compress ? "compressed.btrace" : "raw.btrace");
+    const uint32_t records = 1000;
+
+    {
+        // A small batch makes the records span several blocks
+        Ptr<BinaryTraceWriter> writer =
+            Create<BinaryTraceWriter>(filename, std::vector<std::string>{"cwnd", "rtt"}, m_compress, 64);
+        for (uint32_t i = 0; i < records; i++)
+        {
+            Simulator::Schedule(MicroSeconds(i * 1500),
+                                &BinaryTraceRoundTripTestCase::WriteRecord,
+                                this,
+                                writer,
+                                i);
+        }
+        Simulator::Run();
+        Simulator::Destroy();
+
+        // Explicit time stamps, special values and a time going backwards
+        writer->Write(Seconds(10), {std::numeric_limits<double>::infinity(), -0.0});
+        writer->Write(Seconds(5), {std::nan(""), 1e300});
+        NS_TEST_EXPECT_MSG_EQ(writer->GetRecords(), records + 2, "Wrong record count");
+    }
+
+    BinaryTraceReader reader(filename);
+    NS_TEST_ASSERT_MSG_EQ(reader.IsValid(), true, "Header not read back");
+    NS_TEST_EXPECT_MSG_EQ(reader.IsCompressed(), m_compress, "Wrong compression flag");
+    NS_TEST_ASSERT_MSG_EQ(reader.GetColumns().size(), 2, "Wrong column count");
+    NS_TEST_EXPECT_MSG_EQ(reader.GetColumns()[0], "cwnd", "Wrong column name");
+    NS_TEST_EXPECT_MSG_EQ(reader.GetColumns()[1], "rtt", "Wrong column name");
+
+    Time time;
+    std::vector<double> values;
+    for (uint32_t i = 0; i < records; i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(reader.Read(time, values), true, "Missing record " << i);
+        NS_TEST_EXPECT_MSG_EQ(time, MicroSeconds(i * 1500), "Wrong time of record " << i);
+        NS_TEST_EXPECT_MSG_EQ(values[0], i * 524.0, "Wrong cwnd in record " << i);
+        NS_TEST_EXPECT_MSG_EQ(values[1], i * 0.001 - 0.5, "Wrong rtt in record " << i);
+    }
+
+    NS_TEST_ASSERT_MSG_EQ(reader.Read(time, values), true, "Missing record");
+    NS_TEST_EXPECT_MSG_EQ(time, Seconds(10), "Wrong time");
+    NS_TEST_EXPECT_MSG_EQ(std::isinf(values[0]), true, "Infinity not kept");
+    NS_TEST_EXPECT_MSG_EQ(std::signbit(values[1]), true, "Negative zero not kept");
+    NS_TEST_ASSERT_MSG_EQ(reader.Read(time, values), true, "Missing record");
+    NS_TEST_EXPECT_MSG_EQ(time, Seconds(5), "Backwards time not kept");
+    NS_TEST_EXPECT_MSG_EQ(std::isnan(values[0]), true, "NaN not kept");
+    NS_TEST_EXPECT_MSG_EQ(values[1], 1e300, "Large value not kept");
+    NS_TEST_EXPECT_MSG_EQ(reader.Read(time, values), false, "Records past the end");
+}
+
+/**
+ * @ingroup network-test
+ * @ingroup tests
+ *
+ * @brief BinaryTraceReader rejects files that are not binary traces.
+ */
+class BinaryTraceInvalidTestCase : public TestCase
+{
+  public:
+    BinaryTraceInvalidTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+BinaryTraceInvalidTestCase::BinaryTraceInvalidTestCase()
+    : TestCase("Binary trace reader rejects text files")
+{
+}
+
+void
+BinaryTraceInvalidTestCase::DoRun()
+{
+    std::string filename = CreateTempDirFilename("cwnd.plotme");
+    {
+        std::ofstream text(filename);
+        text << "0.1 10\n0.2 11\n";
+    }
+    BinaryTraceReader reader(filename);
+    NS_TEST_EXPECT_MSG_EQ(reader.IsValid(), false, "Text file accepted");
+
+    BinaryTraceReader missing(CreateTempDirFilename("missing.btrace"));
+    NS_TEST_EXPECT_MSG_EQ(missing.IsValid(), false, "Missing file accepted");
+}
+
+/**
+ * @ingroup network-test
+ * @ingroup tests
+ *
+ * @brief Binary trace TestSuite
+ */
+class BinaryTraceTestSuite : public TestSuite
+{
+  public:
+    BinaryTraceTestSuite();
+};
+
+BinaryTraceTestSuite::BinaryTraceTestSuite()
+    : TestSuite("binary-trace", Type::UNIT)
+{
+    AddTestCase(new BinaryTraceRoundTripTestCase(false), TestCase::Duration::QUICK);
+    AddTestCase(new BinaryTraceRoundTripTestCase(true), TestCase::Duration::QUICK);
+    AddTestCase(new BinaryTraceInvalidTestCase, TestCase::Duration::QUICK);
+}
+
+static BinaryTraceTestSuite g_binaryTraceTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,216 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/double.h"
+#include "ns3/enum.h"
+#include "ns3/object-factory.h"
+#include "ns3/reorder-queue.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * @ingroup network-test
+ * @ingroup tests
+ *
+ * ReorderQueue unit tests.
+ */
+class ReorderQueueTestCase : public TestCase
+{
+  public:
+    ReorderQueueTestCase();
+    void DoRun() override;
+
+  private:
+    /**
+     * Enqueue n packets, then dequeue all of them.
+     * @param queue the queue
+     * @param n the number of packets
+     * @returns the enqueue positions of the packets, in dequeue order
+     */
+    std::vector<uint32_t> Drain(Ptr<ReorderQueue<Packet>> queue, uint32_t n);
+
+    /**
+     * Count a reordered packet.
+     * @param item the packet
+     * @param offset its offset
+     */
+    void Reordered(Ptr<const Packet> item, double offset);
+
+    uint32_t m_reordered; //!< Number of packets reported as reordered
+};
+
+ReorderQueueTestCase::ReorderQueueTestCase()
+    : TestCase("Sanity check on the reorder queue implementation")
+{
+}
+
+std::vector<uint32_t>
+ReorderQueueTestCase::Drain(Ptr<ReorderQueue<Packet>> queue, uint32_t n)
+{
+    std::vector<uint64_t> uids;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        Ptr<Packet> p = Create<Packet>(100);
+        uids.push_back(p->GetUid());
+        queue->Enqueue(p);
+    }
+
+    std::vector<uint32_t> order;
+    while (Ptr<Packet> p = queue->Dequeue())
+    {
+        order.push_back(std::find(uids.begin(), uids.end(), p->GetUid()) - uids.begin());
+    }
+    return order;
+}
+
+void
+ReorderQueueTestCase::Reordered(Ptr<const Packet> item, double offset)
+{
+    m_reordered++;
+}
+
+void
+ReorderQueueTestCase::DoRun()
+{
+    // PATTERN: after 3 packets in sequence, one packet is overtaken by 5
+    {
+        Ptr<ReorderQueue<Packet>> queue = CreateObject<ReorderQueue<Packet>>();
+        m_reordered = 0;
+        queue->TraceConnectWithoutContext("Reordered",
+                                          MakeCallback(&ReorderQueueTestCase::Reordered, this));
+        std::vector<uint32_t> order = Drain(queue, 12);
+        std::vector<uint32_t> expected{0, 1, 2, 4, 5, 6, 7, 8, 3, 9, 10, 11};
+        NS_TEST_EXPECT_MSG_EQ((order == expected), true, "Unexpected PATTERN order");
+        NS_TEST_EXPECT_MSG_EQ(m_reordered, 1, "One packet should be reported as reordered");
+        NS_TEST_EXPECT_MSG_EQ(queue->GetTotalReceivedPackets(), 12, "Queue stats bypassed");
+        NS_TEST_EXPECT_MSG_EQ(queue->GetTotalDroppedPackets(), 0, "Unexpected drops");
+        NS_TEST_EXPECT_MSG_EQ(queue->GetNBytes(), 0, "Queue should be empty");
+    }
+
+    // A held packet is released when it is the only one left
+    {
+        Ptr<ReorderQueue<Packet>> queue = CreateObject<ReorderQueue<Packet>>();
+        std::vector<uint32_t> order = Drain(queue, 5);
+        std::vector<uint32_t> expected{0, 1, 2, 4, 3};
+        NS_TEST_EXPECT_MSG_EQ((order == expected), true, "Held packet not released");
+    }
+
+    // The size limit of the Queue base class applies
+    {
+        Ptr<ReorderQueue<Packet>> queue = CreateObject<ReorderQueue<Packet>>();
+        queue->SetAttribute("MaxSize", StringValue("4p"));
+        std::vector<uint32_t> order = Drain(queue, 6);
+        NS_TEST_EXPECT_MSG_EQ(order.size(), 4, "MaxSize not enforced");
+        NS_TEST_EXPECT_MSG_EQ(queue->GetTotalDroppedPacketsBeforeEnqueue(), 2, "Drops not counted");
+    }
+
+    // The deprecated MaxLength still sets the size, and its default does not
+    // override the MaxSize given at construction
+    {
+        Ptr<ReorderQueue<Packet>> queue = CreateObject<ReorderQueue<Packet>>();
+        queue->SetAttribute("MaxLength", StringValue("4p"));
+        NS_TEST_EXPECT_MSG_EQ(queue->GetMaxSize(), QueueSize("4p"), "MaxLength not applied");
+        queue = CreateObjectWithAttributes<ReorderQueue<Packet>>("MaxSize", StringValue("3p"));
+        NS_TEST_EXPECT_MSG_EQ(queue->GetMaxSize(), QueueSize("3p"), "MaxSize overridden");
+    }
+
+    // RANDOM with a zero probability keeps the FIFO order
+    {
+        Ptr<ReorderQueue<Packet>> queue = CreateObject<ReorderQueue<Packet>>();
+        queue->SetAttribute("Model", EnumValue(ReorderQueue<Packet>::RANDOM));
+        queue->SetAttribute("ReorderProbability", DoubleValue(0));
+        std::vector<uint32_t> order = Drain(queue, 20);
+        for (uint32_t i = 0; i < order.size(); i++)
+        {
+            NS_TEST_EXPECT_MSG_EQ(order[i], i, "RANDOM with probability 0 reordered");
+        }
+    }
+
+    // RANDOM: every packet is displaced by exactly 2, which keeps the order
+    // but for the last ones; with several packets held at once
+    {
+        Ptr<ReorderQueue<Packet>> queue = CreateObject<ReorderQueue<Packet>>();
+        queue->SetAttribute("Model", EnumValue(ReorderQueue<Packet>::RANDOM));
+        queue->SetAttribute("ReorderProbability", DoubleValue(0.5));
+        queue->SetAttribute("Offset", StringValue("ns3::ConstantRandomVariable[Constant=2]"));
+        queue->SetAttribute("MaxSize", StringValue("200p"));
+        queue->AssignStreams(1);
+        std::vector<uint32_t> order = Drain(queue, 200);
+        NS_TEST_EXPECT_MSG_EQ(order.size(), 200, "Packets lost");
+        uint32_t displaced = 0;
+        for (uint32_t i = 0; i < order.size(); i++)
+        {
+            int32_t shift = static_cast<int32_t>(i) - order[i];
+            NS_TEST_EXPECT_MSG_LT_OR_EQ(std::abs(shift), 2, "Packet displaced too far");
+            displaced += shift > 0 ? 1 : 0;
+        }
+        NS_TEST_EXPECT_MSG_GT(displaced, 50, "Too few packets reordered");
+        NS_TEST_EXPECT_MSG_LT(displaced, 150, "Too many packets reordered");
+    }
+
+    // TRACE: offsets replayed cyclically from a file
+    {
+        std::string filename = CreateTempDirFilename("offsets.txt");
+        {
+            std::ofstream file(filename);
+            file << "0\n2\n0\n0\n";
+        }
+        Ptr<ReorderQueue<Packet>> queue = CreateObject<ReorderQueue<Packet>>();
+        queue->SetAttribute("Model", EnumValue(ReorderQueue<Packet>::TRACE));
+        queue->SetAttribute("OffsetTraceFile", StringValue(filename));
+        std::vector<uint32_t> order = Drain(queue, 8);
+        std::vector<uint32_t> expected{0, 2, 3, 1, 4, 6, 7, 5};
+        NS_TEST_EXPECT_MSG_EQ((order == expected), true, "Unexpected TRACE order");
+    }
+
+    // TIME: a packet is overtaken by the packets enqueued within its offset
+    {
+        Ptr<ReorderQueue<Packet>> queue = CreateObject<ReorderQueue<Packet>>();
+        queue->SetAttribute("Model", EnumValue(ReorderQueue<Packet>::RANDOM));
+        queue->SetAttribute("OffsetUnit", EnumValue(ReorderQueue<Packet>::TIME));
+        queue->SetAttribute("ReorderProbability", DoubleValue(1));
+        queue->SetAttribute("Offset", StringValue("ns3::ConstantRandomVariable[Constant=0.0025]"));
+
+        Ptr<Packet> first = Create<Packet>(100);
+        queue->Enqueue(first);
+        queue->SetAttribute("ReorderProbability", DoubleValue(0));
+        for (uint32_t ms = 1; ms <= 3; ms++)
+        {
+            Simulator::Schedule(MilliSeconds(ms), [queue]() {
+                queue->Enqueue(Create<Packet>(100));
+            });
+        }
+        Simulator::Run();
+        Simulator::Destroy();
+
+        NS_TEST_EXPECT_MSG_NE(queue->Dequeue()->GetUid(), first->GetUid(), "Not overtaken");
+        NS_TEST_EXPECT_MSG_NE(queue->Dequeue()->GetUid(), first->GetUid(), "Not overtaken");
+        NS_TEST_EXPECT_MSG_EQ(queue->Dequeue()->GetUid(), first->GetUid(), "Overtaken too much");
+        NS_TEST_EXPECT_MSG_NE(queue->Dequeue(), nullptr, "Packet lost");
+    }
+}
+
+/**
+ * @ingroup network-test
+ * @ingroup tests
+ *
+ * @brief ReorderQueue TestSuite
+ */
+static class ReorderQueueTestSuite : public TestSuite
+{
+  public:
+    ReorderQueueTestSuite()
+        : TestSuite("reorder-queue", Type::UNIT)
+    {
+        AddTestCase(new ReorderQueueTestCase(), TestCase::Duration::QUICK);
+    }
+} g_reorderQueueTestSuite; ///< the test suite
@@ -0,0 +1,445 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "binary-trace.h"
+
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <cstring>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("BinaryTrace");
+
+namespace
+{
+
+const char MAGIC[8] = {'N', 'S', '3', 'B', 'T', 'R', 'C', '\0'}; //!< File magic
+const uint32_t VERSION = 1;                                      //!< File format version
+const uint32_t FLAG_COMPRESSED = 1;                              //!< Delta coded columns
+
+/**
+ * Append a little endian integer to a buffer.
+ * @param buf the buffer
+ * @param v the value
+ * @param bytes the width of the value
+ */
+void
+PutLe(std::vector<uint8_t>& buf, uint64_t v, int bytes)
+{
+    for (int i = 0; i < bytes; i++)
+    {
+        buf.push_back(static_cast<uint8_t>(v >> (8 * i)));
+    }
+}
+
+/**
+ * Read a little endian integer from a buffer.
+ * @param p the buffer position, advanced past the value
+ * @param bytes the width of the value
+ * @returns the value
+ */
+uint64_t
+GetLe(const uint8_t*& p, int bytes)
+{
+    uint64_t v = 0;
+    for (int i = 0; i < bytes; i++)
+    {
+        v |= static_cast<uint64_t>(*p++) << (8 * i);
+    }
+    return v;
+}
+
+/**
+ * Append a LEB128 varint to a buffer.
+ * @param buf the buffer
+ * @param v the value
+ */
+void
+PutVarint(std::vector<uint8_t>& buf, uint64_t v)
+{
+    while (v >= 0x80)
+    {
+        buf.push_back(static_cast<uint8_t>(v) | 0x80);
+        v >>= 7;
+    }
+    buf.push_back(static_cast<uint8_t>(v));
+}
+
+/**
+ * Read a LEB128 varint from a buffer.
+ * @param p the buffer position, advanced past the value
+ * @param end the end of the buffer
+ * @param [out] v the value
+ * @returns false if the varint runs past the end of the buffer
+ */
+bool
+GetVarint(const uint8_t*& p, const uint8_t* end, uint64_t& v)
+{
+    v = 0;
+    for (int shift = 0; p != end && shift < 64; shift += 7)
+    {
+        uint8_t byte = *p++;
+        v |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Reverse the byte order, so that the sign, exponent and high mantissa
+ * bits of an XORed double end up in the low, varint friendly, bytes.
+ * @param v the value
+ * @returns the byte-reversed value
+ */
+uint64_t
+ReverseBytes(uint64_t v)
+{
+    uint64_t r = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        r = (r << 8) | ((v >> (8 * i)) & 0xff);
+    }
+    return r;
+}
+
+/**
+ * @param d a double
+ * @returns its IEEE 754 bits
+ */
+uint64_t
+DoubleBits(double d)
+{
+    uint64_t v;
+    std::memcpy(&v, &d, sizeof(v));
+    return v;
+}
+
+/**
+ * @param v IEEE 754 bits
+ * @returns the double
+ */
+double
+BitsDouble(uint64_t v)
+{
+    double d;
+    std::memcpy(&d, &v, sizeof(d));
+    return d;
+}
+
+} // namespace
+
+BinaryTraceWriter::BinaryTraceWriter(std::string filename,
+                                     std::vector<std::string> columns,
+                                     bool compress,
+                                     uint32_t batchSize)
+    : m_columns(columns.size()),
+      m_compress(compress),
+      m_batchSize(batchSize),
+      m_values(columns.size()),
+      m_records(0)
+{
+    NS_LOG_FUNCTION(this << filename << compress << batchSize);
+    NS_ABORT_MSG_IF(batchSize == 0, "Batch size must be positive");
+
+    m_file.open(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+    NS_ABORT_MSG_UNLESS(m_file.is_open(), "BinaryTraceWriter: Unable to Open " << filename);
+
+    m_times.reserve(batchSize);
+    for (auto& column : m_values)
+    {
+        column.reserve(batchSize);
+    }
+
+    std::vector<uint8_t> header(MAGIC, MAGIC + sizeof(MAGIC));
+    PutLe(header, VERSION, 4);
+    PutLe(header, compress ? FLAG_COMPRESSED : 0, 4);
+    PutLe(header, m_columns, 4);
+    for (const auto& name : columns)
+    {
+        PutLe(header, name.size(), 4);
+        header.insert(header.end(), name.begin(), name.end());
+    }
+    m_file.write(reinterpret_cast<const char*>(header.data()), header.size());
+}
+
+BinaryTraceWriter::~BinaryTraceWriter()
+{
+    NS_LOG_FUNCTION(this);
+    Flush();
+}
+
+void
+BinaryTraceWriter::Write(std::initializer_list<double> values)
+{
+    Write(Simulator::Now(), values);
+}
+
+void
+BinaryTraceWriter::Write(Time time, std::initializer_list<double> values)
+{
+    NS_ASSERT_MSG(values.size() == m_columns,
+                  "Expected " << m_columns << " values, got " << values.size());
+
+    m_times.push_back(time.GetNanoSeconds());
+    auto column = m_values.begin();
+    for (double v : values)
+    {
+        (column++)->push_back(v);
+    }
+    m_records++;
+
+    if (m_times.size() >= m_batchSize)
+    {
+        WriteBlock();
+    }
+}
+
+void
+BinaryTraceWriter::Flush()
+{
+    NS_LOG_FUNCTION(this);
+    WriteBlock();
+    m_file.flush();
+}
+
+uint64_t
+BinaryTraceWriter::GetRecords() const
+{
+    return m_records;
+}
+
+void
+BinaryTraceWriter::WriteBlock()
+{
+    if (m_times.empty())
+    {
+        return;
+    }
+    NS_LOG_FUNCTION(this << m_times.size());
+
+    m_block.clear();
+    if (m_compress)
+    {
+        int64_t prevTime = 0;
+        for (int64_t t : m_times)
+        {
+            int64_t delta = t - prevTime;
+            PutVarint(m_block, (static_cast<uint64_t>(delta) << 1) ^ (delta >> 63));
+            prevTime = t;
+        }
+        for (const auto& column : m_values)
+        {
+            uint64_t prev = 0;
+            for (double v : column)
+            {
+                uint64_t bits = DoubleBits(v);
+                PutVarint(m_block, ReverseBytes(bits ^ prev));
+                prev = bits;
+            }
+        }
+    }
+    else
+    {
+        for (int64_t t : m_times)
+        {
+            PutLe(m_block, t, 8);
+        }
+        for (const auto& column : m_values)
+        {
+            for (double v : column)
+            {
+                PutLe(m_block, DoubleBits(v), 8);
+            }
+        }
+    }
+
+    std::vector<uint8_t> header;
+    PutLe(header, m_times.size(), 4);
+    PutLe(header, m_block.size(), 4);
+    m_file.write(reinterpret_cast<const char*>(header.data()), header.size());
+    m_file.write(reinterpret_cast<const char*>(m_block.data()), m_block.size());
+
+    m_times.clear();
+    for (auto& column : m_values)
+    {
+        column.clear();
+    }
+}
+
+BinaryTraceReader::BinaryTraceReader(std::string filename)
+    : m_valid(false),
+      m_compress(false),
+      m_next(0)
+{
+    NS_LOG_FUNCTION(this << filename);
+
+    m_file.open(filename, std::ios::in | std::ios::binary);
+    if (!m_file.is_open())
+    {
+        return;
+    }
+
+    uint8_t fixed[sizeof(MAGIC) + 12];
+    if (!m_file.read(reinterpret_cast<char*>(fixed), sizeof(fixed)) ||
+        std::memcmp(fixed, MAGIC, sizeof(MAGIC)) != 0)
+    {
+        return;
+    }
+    const uint8_t* p = fixed + sizeof(MAGIC);
+    uint32_t version = GetLe(p, 4);
+    uint32_t flags = GetLe(p, 4);
+    uint32_t columns = GetLe(p, 4);
+    if (version != VERSION)
+    {
+        return;
+    }
+    m_compress = flags & FLAG_COMPRESSED;
+
+    for (uint32_t i = 0; i < columns; i++)
+    {
+        uint8_t len[4];
+        if (!m_file.read(reinterpret_cast<char*>(len), sizeof(len)))
+        {
+            return;
+        }
+        const uint8_t* q = len;
+        std::string name(GetLe(q, 4), '\0');
+        if (!m_file.read(name.data(), name.size()))
+        {
+            return;
+        }
+        m_columns.push_back(name);
+    }
+    m_values.resize(columns);
+    m_valid = true;
+}
+
+bool
+BinaryTraceReader::IsValid() const
+{
+    return m_valid;
+}
+
+const std::vector<std::string>&
+BinaryTraceReader::GetColumns() const
+{
+    return m_columns;
+}
+
+bool
+BinaryTraceReader::IsCompressed() const
+{
+    return m_compress;
+}
+
+bool
+BinaryTraceReader::Read(Time& time, std::vector<double>& values)
+{
+    if (!m_valid)
+    {
+        return false;
+    }
+    while (m_next >= m_times.size())
+    {
+        if (!ReadBlock())
+        {
+            return false;
+        }
+    }
+
+    time = NanoSeconds(m_times[m_next]);
+    values.resize(m_columns.size());
+    for (std::size_t i = 0; i < m_columns.size(); i++)
+    {
+        values[i] = m_values[i][m_next];
+    }
+    m_next++;
+    return true;
+}
+
+bool
+BinaryTraceReader::ReadBlock()
+{
+    uint8_t header[8];
+    if (!m_file.read(reinterpret_cast<char*>(header), sizeof(header)))
+    {
+        return false;
+    }
+    const uint8_t* h = header;
+    uint32_t records = GetLe(h, 4);
+    uint32_t bytes = GetLe(h, 4);
+
+    std::vector<uint8_t> payload(bytes);
+    if (!m_file.read(reinterpret_cast<char*>(payload.data()), bytes))
+    {
+        return false;
+    }
+
+    m_next = 0;
+    m_times.assign(records, 0);
+    for (auto& column : m_values)
+    {
+        column.assign(records, 0);
+    }
+
+    const uint8_t* p = payload.data();
+    const uint8_t* end = p + bytes;
+    if (m_compress)
+    {
+        int64_t prevTime = 0;
+        for (auto& t : m_times)
+        {
+            uint64_t z;
+            if (!GetVarint(p, end, z))
+            {
+                return false;
+            }
+            prevTime += static_cast<int64_t>(z >> 1) ^ -static_cast<int64_t>(z & 1);
+            t = prevTime;
+        }
+        for (auto& column : m_values)
+        {
+            uint64_t prev = 0;
+            for (auto& v : column)
+            {
+                uint64_t x;
+                if (!GetVarint(p, end, x))
+                {
+                    return false;
+                }
+                prev ^= ReverseBytes(x);
+                v = BitsDouble(prev);
+            }
+        }
+    }
+    else
+    {
+        if (bytes != static_cast<uint64_t>(records) * 8 * (1 + m_values.size()))
+        {
+            return false;
+        }
+        for (auto& t : m_times)
+        {
+            t = static_cast<int64_t>(GetLe(p, 8));
+        }
+        for (auto& column : m_values)
+        {
+            for (auto& v : column)
+            {
+                v = BitsDouble(GetLe(p, 8));
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace ns3
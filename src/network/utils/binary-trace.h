@@ -0,0 +1,172 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef BINARY_TRACE_H
+#define BINARY_TRACE_H
+
+#include "ns3/nstime.h"
+#include "ns3/simple-ref-count.h"
+
+#include <fstream>
+#include <initializer_list>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @brief Buffered, columnar binary trace file writer.
+ *
+ * A cheaper alternative to formatting every trace sample as text through
+ * an OutputStreamWrapper. Each record is the simulation time at which it
+ * was written plus a fixed number of double values, one per column named
+ * in the schema header. Records are buffered in memory, column by column,
+ * and written out as one block every \c batchSize records, on Flush(), and
+ * when the writer is destroyed.
+ *
+ * File layout (all integers little endian):
+ *
+ * \verbatim
+   header:  "NS3BTRC\0" | uint32 version | uint32 flags | uint32 columns
+            | columns x (uint32 length, name bytes)
+   block:   uint32 records | uint32 payload bytes | payload
+   payload: the time column (int64 ns), then each value column (IEEE 754
+            double), each stored as <records> contiguous values
+   \endverbatim
+ *
+ * With compression enabled (flag bit 0) each column of a block is delta
+ * coded instead: times as zigzag varints of the difference to the previous
+ * record, values as varints of the byte-reversed XOR with the previous
+ * value. Slowly changing traces such as cwnd or RTT then take one or two
+ * bytes per value. The encoding restarts at every block.
+ *
+ * BinaryTraceReader reads the files back; the binary-trace-to-plotme
+ * example converts them to the gnuplot text format.
+ *
+ * As with OutputStreamWrapper, a Ptr<BinaryTraceWriter> can be bound to a
+ * trace sink:
+ *
+ * \code{.cpp}
+ * void
+ * CwndChange(Ptr<BinaryTraceWriter> writer, uint32_t oldCwnd, uint32_t newCwnd)
+ * {
+ *     writer->Write({static_cast<double>(newCwnd)});
+ * }
+ * \endcode
+ */
+class BinaryTraceWriter : public SimpleRefCount<BinaryTraceWriter>
+{
+  public:
+    /**
+     * Constructor
+     * @param filename file name
+     * @param columns names of the value columns
+     * @param compress delta code the columns
+     * @param batchSize number of records buffered before a block is written
+     */
+    BinaryTraceWriter(std::string filename,
+                      std::vector<std::string> columns,
+                      bool compress = false,
+                      uint32_t batchSize = 4096);
+    ~BinaryTraceWriter();
+
+    /**
+     * Append a record stamped with the current simulation time.
+     *
+     * @param values one value per column
+     */
+    void Write(std::initializer_list<double> values);
+
+    /**
+     * Append a record with an explicit time stamp.
+     *
+     * @param time the record time
+     * @param values one value per column
+     */
+    void Write(Time time, std::initializer_list<double> values);
+
+    /**
+     * Write the buffered records to the file.
+     */
+    void Flush();
+
+    /**
+     * @returns the number of records written so far, buffered ones included
+     */
+    uint64_t GetRecords() const;
+
+  private:
+    /**
+     * Encode the buffered records as one block and hand it to the file.
+     */
+    void WriteBlock();
+
+    std::ofstream m_file;                      //!< Output file
+    uint32_t m_columns;                        //!< Number of value columns
+    bool m_compress;                           //!< Delta code the columns
+    uint32_t m_batchSize;                      //!< Records per block
+    std::vector<int64_t> m_times;              //!< Buffered time column
+    std::vector<std::vector<double>> m_values; //!< Buffered value columns
+    std::vector<uint8_t> m_block;              //!< Encoding buffer
+    uint64_t m_records;                        //!< Records written
+};
+
+/**
+ * @brief Reader for the files produced by BinaryTraceWriter.
+ */
+class BinaryTraceReader
+{
+  public:
+    /**
+     * Open a trace file and read its header.
+     *
+     * @param filename file name
+     */
+    BinaryTraceReader(std::string filename);
+
+    /**
+     * @returns false if the file could not be opened or has no valid header
+     */
+    bool IsValid() const;
+
+    /**
+     * @returns the names of the value columns
+     */
+    const std::vector<std::string>& GetColumns() const;
+
+    /**
+     * @returns true if the file is delta coded
+     */
+    bool IsCompressed() const;
+
+    /**
+     * Read the next record.
+     *
+     * @param [out] time the record time
+     * @param [out] values one value per column
+     * @returns false at the end of the file or on a truncated block
+     */
+    bool Read(Time& time, std::vector<double>& values);
+
+  private:
+    /**
+     * Read and decode the next block.
+     * @returns false if there is no complete block left
+     */
+    bool ReadBlock();
+
+    std::ifstream m_file;                      //!< Input file
+    bool m_valid;                              //!< The header was valid
+    bool m_compress;                           //!< The file is delta coded
+    std::vector<std::string> m_columns;        //!< Names of the value columns
+    std::vector<int64_t> m_times;              //!< Decoded time column
+    std::vector<std::vector<double>> m_values; //!< Decoded value columns
+    std::size_t m_next;                        //!< Next record of the block
+};
+
+} // namespace ns3
+
+#endif /* BINARY_TRACE_H */
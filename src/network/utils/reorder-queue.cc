@@ -8,6 +8,16 @@
 
 #include "reorder-queue.h"
 
+#include "ns3/abort.h"
+#include "ns3/double.h"
+#include "ns3/enum.h"
+#include "ns3/pointer.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+
+#include <fstream>
+
 namespace ns3
 {
 
@@ -19,39 +29,84 @@ template <typename Item>
 TypeId
 ReorderQueue<Item>::GetTypeId()
 {
-    static TypeId tid = TypeId(GetTemplateClassName<ReorderQueue<Item>>())
-                            .SetParent<Queue<Item>>()
-                            .SetGroupName("Network")
-                            .template AddConstructor<ReorderQueue<Item>>()
-                            .AddAttribute("MaxLength",
-                                          "The max queue size",
-                                          QueueSizeValue(QueueSize("100p")),
-                                          MakeQueueSizeAccessor(&ReorderQueue::m_maxSize),
-                                          MakeQueueSizeChecker())
-                            .AddAttribute("ReorderDepth",
-                                          "The number of packets that will bypass a held packet",
-                                          UintegerValue(5),
-                                          MakeUintegerAccessor(&ReorderQueue::m_reorderDepth),
-                                          MakeUintegerChecker<uint32_t>())
-                            .AddAttribute("InSequenceLength",
-                                          "The number of packets until a reordering event",
-                                          UintegerValue(3),
-                                          MakeUintegerAccessor(&ReorderQueue::m_inSequenceLength),
-                                          MakeUintegerChecker<uint32_t>());
+    static TypeId tid =
+        TypeId(GetTemplateClassName<ReorderQueue<Item>>())
+            .SetParent<Queue<Item>>()
+            .SetGroupName("Network")
+            .template AddConstructor<ReorderQueue<Item>>()
+            .AddAttribute("MaxSize",
+                          "The max queue size",
+                          QueueSizeValue(QueueSize("100p")),
+                          MakeQueueSizeAccessor(&QueueBase::SetMaxSize, &QueueBase::GetMaxSize),
+                          MakeQueueSizeChecker())
+            .AddAttribute("MaxLength",
+                          "The max queue size, if not zero",
+                          QueueSizeValue(QueueSize("0p")),
+                          MakeQueueSizeAccessor(&ReorderQueue::SetMaxLength,
+                                                &ReorderQueue::GetMaxLength),
+                          MakeQueueSizeChecker(),
+                          TypeId::SupportLevel::DEPRECATED,
+                          "Use the MaxSize attribute.")
+            .AddAttribute("Model",
+                          "How the per-packet offsets are drawn",
+                          EnumValue(ReorderQueue::PATTERN),
+                          MakeEnumAccessor<Model>(&ReorderQueue::m_model),
+                          MakeEnumChecker(ReorderQueue::PATTERN,
+                                          "PATTERN",
+                                          ReorderQueue::RANDOM,
+                                          "RANDOM",
+                                          ReorderQueue::TRACE,
+                                          "TRACE"))
+            .AddAttribute("OffsetUnit",
+                          "Whether the offsets are numbers of packets or seconds",
+                          EnumValue(ReorderQueue::PACKETS),
+                          MakeEnumAccessor<OffsetUnit>(&ReorderQueue::m_unit),
+                          MakeEnumChecker(ReorderQueue::PACKETS,
+                                          "PACKETS",
+                                          ReorderQueue::TIME,
+                                          "TIME"))
+            .AddAttribute("ReorderDepth",
+                          "PATTERN: the number of packets that will bypass a held packet",
+                          UintegerValue(5),
+                          MakeUintegerAccessor(&ReorderQueue::m_reorderDepth),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("InSequenceLength",
+                          "PATTERN: the number of packets until a reordering event",
+                          UintegerValue(3),
+                          MakeUintegerAccessor(&ReorderQueue::m_inSequenceLength),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("ReorderProbability",
+                          "RANDOM: the probability that a packet is given an offset",
+                          DoubleValue(0.1),
+                          MakeDoubleAccessor(&ReorderQueue::m_reorderProbability),
+                          MakeDoubleChecker<double>(0, 1))
+            .AddAttribute("Offset",
+                          "RANDOM: the offset of a reordered packet, in OffsetUnit",
+                          StringValue("ns3::UniformRandomVariable[Min=1|Max=10]"),
+                          MakePointerAccessor(&ReorderQueue::m_offset),
+                          MakePointerChecker<RandomVariableStream>())
+            .AddAttribute("OffsetTraceFile",
+                          "TRACE: a file with one offset, in OffsetUnit, per line",
+                          StringValue(""),
+                          MakeStringAccessor(&ReorderQueue::m_traceFile),
+                          MakeStringChecker())
+            .AddTraceSource("Reordered",
+                            "A packet was served after a packet enqueued later than itself",
+                            MakeTraceSourceAccessor(&ReorderQueue::m_reorderedTrace),
+                            "ns3::ReorderQueue::ReorderedTracedCallback");
     return tid;
 }
 
 template <typename Item>
 ReorderQueue<Item>::ReorderQueue()
     : Queue<Item>(),
-      m_packets(),
-      m_bytesInQueue(0),
-      m_holdCount(0),
-      m_inSequenceCount(0),
-      m_held(nullptr),
+      m_traceNext(0),
+      m_enqueued(0),
+      m_maxServed(0),
       NS_LOG_TEMPLATE_DEFINE("ReorderQueue")
 {
     NS_LOG_FUNCTION(this);
+    m_decision = CreateObject<UniformRandomVariable>();
 }
 
 template <typename Item>
@@ -60,34 +115,127 @@ ReorderQueue<Item>::~ReorderQueue()
     NS_LOG_FUNCTION(this);
 }
 
+template <typename Item>
+void
+ReorderQueue<Item>::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_heap = {};
+    m_decision = nullptr;
+    m_offset = nullptr;
+    Queue<Item>::DoDispose();
+}
+
+template <typename Item>
+int64_t
+ReorderQueue<Item>::AssignStreams(int64_t stream)
+{
+    NS_LOG_FUNCTION(this << stream);
+    m_decision->SetStream(stream);
+    m_offset->SetStream(stream + 1);
+    return 2;
+}
+
+template <typename Item>
+void
+ReorderQueue<Item>::SetMaxLength(QueueSize size)
+{
+    NS_LOG_FUNCTION(this << size);
+    // The zero default leaves alone the MaxSize set before, at construction
+    if (size.GetValue() > 0)
+    {
+        QueueBase::SetMaxSize(size);
+    }
+}
+
+template <typename Item>
+QueueSize
+ReorderQueue<Item>::GetMaxLength() const
+{
+    return QueueBase::GetMaxSize();
+}
+
+template <typename Item>
+void
+ReorderQueue<Item>::LoadTrace()
+{
+    NS_LOG_FUNCTION(this << m_traceFile);
+
+    std::ifstream file(m_traceFile);
+    NS_ABORT_MSG_UNLESS(file.is_open(), "ReorderQueue: Unable to open " << m_traceFile);
+    double offset;
+    while (file >> offset)
+    {
+        m_traceOffsets.push_back(offset);
+    }
+    NS_ABORT_MSG_IF(m_traceOffsets.empty(), "ReorderQueue: no offsets in " << m_traceFile);
+}
+
+template <typename Item>
+double
+ReorderQueue<Item>::NextOffset()
+{
+    switch (m_model)
+    {
+    case PATTERN: {
+        uint64_t cycle = m_inSequenceLength + m_reorderDepth + 1;
+        return (m_enqueued % cycle == m_inSequenceLength) ? m_reorderDepth : 0;
+    }
+    case RANDOM:
+        return m_decision->GetValue() < m_reorderProbability ? m_offset->GetValue() : 0;
+    case TRACE:
+        if (m_traceOffsets.empty())
+        {
+            LoadTrace();
+        }
+        return m_traceOffsets[m_traceNext++ % m_traceOffsets.size()];
+    }
+    return 0;
+}
+
 template <typename Item>
 bool
 ReorderQueue<Item>::Enqueue(Ptr<Item> item)
 {
     NS_LOG_FUNCTION(this << item);
 
-    if (m_maxSize.GetUnit() == QueueSizeUnit::PACKETS && (m_packets.size() >= m_maxSize.GetValue()))
+    typename Queue<Item>::Iterator it;
+    if (!DoEnqueue(GetContainer().end(), item, it))
     {
-        NS_LOG_LOGIC("Queue full (at max packets) -- droppping pkt");
-        DropBeforeEnqueue(item);
         return false;
     }
 
-    if (m_maxSize.GetUnit() == QueueSizeUnit::BYTES &&
-        (m_bytesInQueue + item->GetSize() >= m_maxSize.GetValue()))
+    double offset = std::max(NextOffset(), 0.0);
+    double key;
+    if (m_unit == PACKETS || m_model == PATTERN)
     {
-        NS_LOG_LOGIC("Queue full (packet would exceed max bytes) -- droppping pkt");
-        DropBeforeEnqueue(item);
-        return false;
+        // The half packet makes exactly 'offset' later packets overtake this one
+        key = m_enqueued + (offset > 0 ? offset + 0.5 : 0);
     }
+    else
+    {
+        key = Simulator::Now().GetSeconds() + offset;
+    }
+    NS_LOG_LOGIC("Packet " << m_enqueued << " offset " << offset << " key " << key);
 
-    m_bytesInQueue += item->GetSize();
-    m_packets.push(item);
+    m_heap.push(Entry{key, m_enqueued++, offset, it});
+    return true;
+}
 
-    NS_LOG_LOGIC("Number packets " << m_packets.size());
-    NS_LOG_LOGIC("Number bytes " << m_bytesInQueue);
+template <typename Item>
+typename ReorderQueue<Item>::Entry
+ReorderQueue<Item>::PopNext()
+{
+    Entry next = m_heap.top();
+    m_heap.pop();
 
-    return true;
+    if (next.index < m_maxServed)
+    {
+        NS_LOG_LOGIC("Packet " << next.index << " served out of order");
+        m_reorderedTrace(*next.item, next.offset);
+    }
+    m_maxServed = std::max(m_maxServed, next.index + 1);
+    return next;
 }
 
 template <typename Item>
@@ -96,60 +244,17 @@ ReorderQueue<Item>::Dequeue()
 {
     NS_LOG_FUNCTION(this);
 
-    if (m_packets.empty())
+    if (m_heap.empty())
     {
         NS_LOG_LOGIC("Queue empty");
         return nullptr;
     }
 
-    Ptr<Item> p;
-    if (m_holdCount == m_reorderDepth && m_held)
-    {
-        p = m_held;
-        m_held = nullptr;
-        m_bytesInQueue -= p->GetSize();
-        NS_LOG_LOGIC("Released " << p->GetUid());
-        m_inSequenceCount = 0;
-        m_holdCount = 0;
-    }
-
-    else
-    {
-        if (m_inSequenceCount == m_inSequenceLength)
-        {
-            m_held = m_packets.front();
-            NS_LOG_LOGIC("Hold " << m_held->GetUid());
-            m_packets.pop();
-            m_inSequenceCount = 0;
-            m_holdCount = 0;
-            if (m_packets.empty())
-            {
-                // We need to release this packet since no others to reorder with
-                NS_LOG_LOGIC("Release " << m_held->GetUid() << " anyway");
-                p = m_held;
-                m_held = nullptr;
-                m_bytesInQueue -= p->GetSize();
-                return p;
-            }
-        }
-        p = m_packets.front();
-        m_packets.pop();
-        m_bytesInQueue -= p->GetSize();
-        NS_LOG_LOGIC("Popped " << p);
-        if (m_held)
-        {
-            m_holdCount++;
-        }
-        else
-        {
-            m_inSequenceCount++;
-        }
-    }
+    Ptr<Item> item = DoDequeue(PopNext().item);
 
-    NS_LOG_LOGIC("Number packets " << m_packets.size());
-    NS_LOG_LOGIC("Number bytes " << m_bytesInQueue);
+    NS_LOG_LOGIC("Popped " << item);
 
-    return p;
+    return item;
 }
 
 template <typename Item>
@@ -158,7 +263,11 @@ ReorderQueue<Item>::Peek() const
 {
     NS_LOG_FUNCTION(this);
 
-    return DoPeek(GetContainer().begin());
+    if (m_heap.empty())
+    {
+        return nullptr;
+    }
+    return DoPeek(m_heap.top().item);
 }
 
 template <typename Item>
@@ -167,7 +276,12 @@ ReorderQueue<Item>::Remove()
 {
     NS_LOG_FUNCTION(this);
 
-    Ptr<Item> item = DoRemove(GetContainer().begin());
+    if (m_heap.empty())
+    {
+        return nullptr;
+    }
+
+    Ptr<Item> item = DoRemove(PopNext().item);
 
     NS_LOG_LOGIC("Removed " << item);
 
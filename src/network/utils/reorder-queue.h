@@ -12,7 +12,11 @@
 #include "queue-size.h"
 #include "queue.h"
 
+#include "ns3/random-variable-stream.h"
+#include "ns3/traced-callback.h"
+
 #include <queue>
+#include <vector>
 
 namespace ns3
 {
@@ -20,7 +24,39 @@ namespace ns3
 /**
  * @ingroup queue
  *
- * @brief A FIFO packet queue that drops tail-end packets on overflow
+ * @brief A drop-tail queue that reorders the packets it serves
+ *
+ * Every enqueued packet is given a release key, its position plus a
+ * per-packet offset, and the queue always serves the packet with the
+ * smallest key. Packets with a positive offset are therefore overtaken by
+ * the packets enqueued after them, and any number of packets can be held
+ * at the same time. The offsets are drawn according to the Model
+ * attribute:
+ *
+ * - PATTERN: a fixed cadence, always counted in packets. After
+ *   InSequenceLength packets, one packet is overtaken by the next
+ *   ReorderDepth packets.
+ * - RANDOM: with probability ReorderProbability, the offset is a sample of
+ *   the Offset random variable, e.g. a small uniform offset for ECMP-like
+ *   multipath reordering or a large one for link-layer retransmissions.
+ * - TRACE: the offsets are read, one per line, from OffsetTraceFile and
+ *   replayed cyclically.
+ *
+ * With OffsetUnit PACKETS the position of a packet is its enqueue index
+ * and an offset of N lets N later packets overtake it. With OffsetUnit
+ * TIME the position is the enqueue time and the offset is in seconds: a
+ * packet is overtaken by the packets enqueued less than offset seconds
+ * after it.
+ *
+ * The queue is work conserving: it never holds a packet back while the
+ * link is idle, so a packet is only overtaken by packets that are in the
+ * queue when it is served. In particular, a TIME offset is not a delay:
+ * on a link that is not loaded, where a packet is served before the next
+ * one is enqueued, TIME offsets have no effect at all, and the amount of
+ * reordering they produce grows with the queueing delay. The packets are kept in the Queue container,
+ * so the size limits, statistics and traces of the Queue base class
+ * apply. The Reordered trace source reports the offset of each packet
+ * served after a packet enqueued later than itself.
  */
 template <typename Item>
 class ReorderQueue : public Queue<Item>
@@ -34,32 +70,119 @@ class ReorderQueue : public Queue<Item>
     /**
      * @brief ReorderQueue Constructor
      *
-     * Creates a droptail queue with a maximum size of 100 packets by default
+     * Creates a reordering queue with a maximum size of 100 packets by default
      */
     ReorderQueue();
 
     ~ReorderQueue() override;
 
+    /// How the per-packet offsets are drawn
+    enum Model
+    {
+        PATTERN, //!< Fixed InSequenceLength / ReorderDepth cadence
+        RANDOM,  //!< ReorderProbability and the Offset random variable
+        TRACE    //!< Offsets replayed from OffsetTraceFile
+    };
+
+    /// The unit of the offsets
+    enum OffsetUnit
+    {
+        PACKETS, //!< Offsets are numbers of packets
+        TIME     //!< Offsets are in seconds
+    };
+
     bool Enqueue(Ptr<Item> item) override;
     Ptr<Item> Dequeue() override;
     Ptr<Item> Remove() override;
     Ptr<const Item> Peek() const override;
 
+    /**
+     * Assign a fixed random variable stream number to the random variables
+     * used by this model.
+     *
+     * @param stream first stream index to use
+     * @return the number of stream indices assigned by this model
+     */
+    int64_t AssignStreams(int64_t stream);
+
+    /**
+     * TracedCallback signature for reordered packets.
+     *
+     * @param [in] item The packet served out of order.
+     * @param [in] offset Its offset, in OffsetUnit.
+     */
+    typedef void (*ReorderedTracedCallback)(Ptr<const Item> item, double offset);
+
+  protected:
+    void DoDispose() override;
+
   private:
-    QueueSize m_maxSize; //!< max queue size
     using Queue<Item>::GetContainer;
     using Queue<Item>::DoEnqueue;
     using Queue<Item>::DoDequeue;
     using Queue<Item>::DoRemove;
     using Queue<Item>::DoPeek;
-    using Queue<Item>::DropBeforeEnqueue;
-    std::queue<Ptr<Item>> m_packets; //!< the packets in the queue
-    uint32_t m_bytesInQueue;         //!< actual bytes in the queue
-    uint32_t m_reorderDepth;         //!< the maximum reorder buffer depth
-    uint32_t m_inSequenceLength;     //!< the length of in-sequence packet burst
-    uint32_t m_holdCount;            //!< number of packets currently held for reordering
-    uint32_t m_inSequenceCount;      //!< number of in-order packets delivered
-    Ptr<Packet> m_held;              //!< pointer to the currently held packet/item
+
+    /// An enqueued packet, ordered by release key
+    struct Entry
+    {
+        double key;                               //!< Release key
+        uint64_t index;                           //!< Enqueue index, breaks ties
+        double offset;                            //!< Offset of the packet
+        typename Queue<Item>::ConstIterator item; //!< Position in the container
+
+        /**
+         * @param other another entry
+         * @returns true if this entry is released after the other one
+         */
+        bool operator>(const Entry& other) const
+        {
+            return key > other.key || (key == other.key && index > other.index);
+        }
+    };
+
+    /**
+     * Draw the offset of the next enqueued packet.
+     * @returns the offset, in OffsetUnit
+     */
+    double NextOffset();
+
+    /**
+     * Remove the packet with the smallest release key from the heap.
+     * @returns its entry
+     */
+    Entry PopNext();
+
+    /** Read OffsetTraceFile into m_traceOffsets. */
+    void LoadTrace();
+
+    /**
+     * Setter of the deprecated MaxLength attribute.
+     * @param size the max queue size, ignored if zero
+     */
+    void SetMaxLength(QueueSize size);
+
+    /**
+     * Getter of the deprecated MaxLength attribute.
+     * @returns the max queue size
+     */
+    QueueSize GetMaxLength() const;
+
+    Model m_model;                         //!< Offset model
+    OffsetUnit m_unit;                     //!< Offset unit
+    uint32_t m_reorderDepth;               //!< PATTERN: offset of the reordered packets
+    uint32_t m_inSequenceLength;           //!< PATTERN: in-sequence packets between them
+    double m_reorderProbability;           //!< RANDOM: probability of a non-zero offset
+    Ptr<UniformRandomVariable> m_decision; //!< RANDOM: decides whether to reorder
+    Ptr<RandomVariableStream> m_offset;    //!< RANDOM: offset distribution
+    std::string m_traceFile;               //!< TRACE: offset trace file
+    std::vector<double> m_traceOffsets;    //!< TRACE: offsets read from the file
+    std::size_t m_traceNext;               //!< TRACE: next offset to replay
+    uint64_t m_enqueued;                   //!< Number of packets enqueued
+    uint64_t m_maxServed;                  //!< Highest enqueue index served plus one
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> m_heap; //!< Release order
+
+    TracedCallback<Ptr<const Item>, double> m_reorderedTrace; //!< Packets served out of order
 
     NS_LOG_TEMPLATE_DECLARE; //!< redefinition of the log component
 };
@@ -0,0 +1,132 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "segmentation-offload.h"
+
+#include "ns3/log.h"
+
+#include <map>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SegmentationOffload");
+
+NS_OBJECT_ENSURE_REGISTERED(GsoTag);
+
+TypeId
+GsoTag::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::GsoTag")
+                            .SetParent<Tag>()
+                            .SetGroupName("Network")
+                            .AddConstructor<GsoTag>();
+    return tid;
+}
+
+TypeId
+GsoTag::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+uint32_t
+GsoTag::GetSerializedSize() const
+{
+    return 2;
+}
+
+void
+GsoTag::Serialize(TagBuffer buf) const
+{
+    buf.WriteU16(m_segmentSize);
+}
+
+void
+GsoTag::Deserialize(TagBuffer buf)
+{
+    m_segmentSize = buf.ReadU16();
+}
+
+void
+GsoTag::Print(std::ostream& os) const
+{
+    os << "GsoSegmentSize=" << m_segmentSize;
+}
+
+GsoTag::GsoTag()
+    : Tag(),
+      m_segmentSize(0)
+{
+}
+
+GsoTag::GsoTag(uint16_t segmentSize)
+    : Tag(),
+      m_segmentSize(segmentSize)
+{
+}
+
+void
+GsoTag::SetSegmentSize(uint16_t segmentSize)
+{
+    m_segmentSize = segmentSize;
+}
+
+uint16_t
+GsoTag::GetSegmentSize() const
+{
+    return m_segmentSize;
+}
+
+/**
+ * @brief Get the registered segmenters
+ * @return the segmenters, by protocol number
+ */
+static std::map<uint16_t, SegmentationOffload::Segmenter>&
+GetSegmenters()
+{
+    static std::map<uint16_t, SegmentationOffload::Segmenter> segmenters;
+    return segmenters;
+}
+
+void
+SegmentationOffload::Register(uint16_t protocol, Segmenter segmenter)
+{
+    NS_LOG_FUNCTION(protocol);
+    GetSegmenters()[protocol] = segmenter;
+}
+
+void
+SegmentationOffload::Unregister(uint16_t protocol)
+{
+    NS_LOG_FUNCTION(protocol);
+    GetSegmenters().erase(protocol);
+}
+
+std::list<Ptr<Packet>>
+SegmentationOffload::Segment(Ptr<Packet> packet, uint16_t protocol)
+{
+    NS_LOG_FUNCTION(packet << protocol);
+
+    GsoTag tag;
+    if (!packet->PeekPacketTag(tag))
+    {
+        return {packet};
+    }
+    auto it = GetSegmenters().find(protocol);
+    if (it == GetSegmenters().end())
+    {
+        NS_LOG_WARN("No segmenter for protocol " << protocol << ", sent unsegmented");
+        return {packet};
+    }
+
+    Ptr<Packet> p = packet->Copy();
+    p->RemovePacketTag(tag);
+    std::list<Ptr<Packet>> segments = it->second(p, tag.GetSegmentSize());
+    NS_LOG_LOGIC("Split " << packet->GetSize() << " bytes into " << segments.size()
+                          << " segments");
+    return segments;
+}
+
+} // namespace ns3
@@ -0,0 +1,118 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SEGMENTATION_OFFLOAD_H
+#define SEGMENTATION_OFFLOAD_H
+
+#include "ns3/callback.h"
+#include "ns3/packet.h"
+#include "ns3/tag.h"
+
+#include <list>
+
+namespace ns3
+{
+
+/**
+ * @ingroup network
+ *
+ * @brief Marks a super-segment, to be split into segments of the given
+ * payload size before it is put on the wire
+ *
+ * A transport protocol may hand down a packet carrying several segments
+ * worth of payload under a single set of headers, much like a GSO/TSO
+ * buffer in Linux. The packet travels through the stack as a single
+ * packet; a NetDevice that supports segmentation offload splits it at
+ * transmit time, otherwise the network layer splits it in software before
+ * handing it to the device.
+ */
+class GsoTag : public Tag
+{
+  public:
+    /**
+     * @brief Get the type ID.
+     * @return the object TypeId
+     */
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+    uint32_t GetSerializedSize() const override;
+    void Serialize(TagBuffer buf) const override;
+    void Deserialize(TagBuffer buf) override;
+    void Print(std::ostream& os) const override;
+    GsoTag();
+
+    /**
+     * Constructs a GsoTag with the given segment size
+     *
+     * @param segmentSize the payload size of the segments
+     */
+    GsoTag(uint16_t segmentSize);
+
+    /**
+     * Sets the payload size of the segments
+     * @param segmentSize the payload size of the segments
+     */
+    void SetSegmentSize(uint16_t segmentSize);
+
+    /**
+     * Gets the payload size of the segments
+     * @returns the payload size of the segments
+     */
+    uint16_t GetSegmentSize() const;
+
+  private:
+    uint16_t m_segmentSize; //!< Payload size of the segments
+};
+
+/**
+ * @ingroup network
+ *
+ * @brief Registry of the functions splitting super-segments
+ *
+ * The protocol that builds the headers of a super-segment registers, for
+ * its protocol number, the function that splits it into segments with
+ * their own headers; a NetDevice calls Segment() on the packets it is
+ * about to transmit, without knowing the protocols involved.
+ */
+class SegmentationOffload
+{
+  public:
+    /**
+     * @brief Split a super-segment into wire packets
+     *
+     * The callback receives the packet, starting with the header of the
+     * registered protocol and without the GsoTag, and the payload size of
+     * the segments.
+     */
+    typedef Callback<std::list<Ptr<Packet>>, Ptr<Packet>, uint16_t> Segmenter;
+
+    /**
+     * @brief Register the segmenter of a protocol
+     * @param protocol the protocol number, as given to NetDevice::Send
+     * @param segmenter the segmenter
+     */
+    static void Register(uint16_t protocol, Segmenter segmenter);
+
+    /**
+     * @brief Remove the segmenter of a protocol, if any
+     * @param protocol the protocol number, as given to NetDevice::Send
+     */
+    static void Unregister(uint16_t protocol);
+
+    /**
+     * @brief Split a packet into wire packets
+     *
+     * A packet without a GsoTag, or for which no segmenter is registered, is
+     * returned unchanged.
+     *
+     * @param packet the packet, starting with the header of the protocol
+     * @param protocol the protocol number, as given to NetDevice::Send
+     * @return the wire packets, in transmission order
+     */
+    static std::list<Ptr<Packet>> Segment(Ptr<Packet> packet, uint16_t protocol);
+};
+
+} // namespace ns3
+
+#endif /* SEGMENTATION_OFFLOAD_H */
@@ -9,12 +9,14 @@
 #include "point-to-point-channel.h"
 #include "ppp-header.h"
 
+#include "ns3/boolean.h"
 #include "ns3/error-model.h"
 #include "ns3/llc-snap-header.h"
 #include "ns3/log.h"
 #include "ns3/mac48-address.h"
 #include "ns3/pointer.h"
 #include "ns3/queue.h"
+#include "ns3/segmentation-offload.h"
 #include "ns3/simulator.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/uinteger.h"
@@ -60,6 +62,13 @@ PointToPointNetDevice::GetTypeId()
                           TimeValue(Seconds(0)),
                           MakeTimeAccessor(&PointToPointNetDevice::m_tInterframeGap),
                           MakeTimeChecker())
+            .AddAttribute("SegmentationOffload",
+                          "Whether the device splits the super-segments (packets with a "
+                          "GsoTag) into wire packets at transmit time; otherwise the "
+                          "network layer splits them before handing them to the device",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&PointToPointNetDevice::m_segmentationOffload),
+                          MakeBooleanChecker())
 
             //
             // Transmit queueing discipline for the device which includes its own set
@@ -167,7 +176,8 @@ PointToPointNetDevice::PointToPointNetDevice()
     : m_txMachineState(READY),
       m_channel(nullptr),
       m_linkUp(false),
-      m_currentPkt(nullptr)
+      m_currentPkt(nullptr),
+      m_segmentationOffload(true)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -196,6 +206,31 @@ PointToPointNetDevice::ProcessHeader(Ptr<Packet> p, uint16_t& param)
     return true;
 }
 
+Ptr<Packet>
+PointToPointNetDevice::Segment(Ptr<Packet> p)
+{
+    NS_LOG_FUNCTION(this << p);
+    NS_ASSERT(m_gsoSegments.empty());
+
+    GsoTag tag;
+    if (!p->PeekPacketTag(tag))
+    {
+        return p;
+    }
+
+    PppHeader ppp;
+    p->RemoveHeader(ppp);
+    m_gsoSegments = SegmentationOffload::Segment(p, PppToEther(ppp.GetProtocol()));
+    for (auto& segment : m_gsoSegments)
+    {
+        segment->AddHeader(ppp);
+    }
+
+    Ptr<Packet> first = m_gsoSegments.front();
+    m_gsoSegments.pop_front();
+    return first;
+}
+
 void
 PointToPointNetDevice::DoDispose()
 {
@@ -204,6 +239,7 @@ PointToPointNetDevice::DoDispose()
     m_channel = nullptr;
     m_receiveErrorModel = nullptr;
     m_currentPkt = nullptr;
+    m_gsoSegments.clear();
     m_queue = nullptr;
     NetDevice::DoDispose();
 }
@@ -271,11 +307,24 @@ PointToPointNetDevice::TransmitComplete()
     m_phyTxEndTrace(m_currentPkt);
     m_currentPkt = nullptr;
 
-    Ptr<Packet> p = m_queue->Dequeue();
-    if (!p)
+    Ptr<Packet> p;
+    if (!m_gsoSegments.empty())
     {
-        NS_LOG_LOGIC("No pending packets in device queue after tx complete");
-        return;
+        //
+        // The wire packets of a super-segment go out back to back.
+        //
+        p = m_gsoSegments.front();
+        m_gsoSegments.pop_front();
+    }
+    else
+    {
+        p = m_queue->Dequeue();
+        if (!p)
+        {
+            NS_LOG_LOGIC("No pending packets in device queue after tx complete");
+            return;
+        }
+        p = Segment(p);
     }
 
     //
@@ -533,7 +582,7 @@ PointToPointNetDevice::Send(Ptr<Packet> packet, const Address& dest, uint16_t pr
         //
         if (m_txMachineState == READY)
         {
-            packet = m_queue->Dequeue();
+            packet = Segment(m_queue->Dequeue());
             m_snifferTrace(packet);
             m_promiscSnifferTrace(packet);
             bool ret = TransmitStart(packet);
@@ -597,6 +646,13 @@ PointToPointNetDevice::SupportsSendFrom() const
     return false;
 }
 
+bool
+PointToPointNetDevice::SupportsSegmentationOffload() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_segmentationOffload;
+}
+
 void
 PointToPointNetDevice::DoMpiReceive(Ptr<Packet> p)
 {
@@ -20,6 +20,7 @@
 #include "ns3/traced-callback.h"
 
 #include <cstring>
+#include <list>
 
 namespace ns3
 {
@@ -186,6 +187,7 @@ class PointToPointNetDevice : public NetDevice
 
     void SetPromiscReceiveCallback(PromiscReceiveCallback cb) override;
     bool SupportsSendFrom() const override;
+    bool SupportsSegmentationOffload() const override;
 
   protected:
     /**
@@ -225,6 +227,18 @@ class PointToPointNetDevice : public NetDevice
      */
     bool ProcessHeader(Ptr<Packet> p, uint16_t& param);
 
+    /**
+     * Split a super-segment taken off the queue into wire packets.
+     *
+     * The first wire packet is returned, the others are kept in
+     * m_gsoSegments and transmitted back to back before the next packet is
+     * taken off the queue. A packet without a GsoTag is returned unchanged.
+     *
+     * @param p the packet taken off the queue, with its PPP header
+     * @returns the first wire packet to transmit
+     */
+    Ptr<Packet> Segment(Ptr<Packet> p);
+
     /**
      * Start Sending a Packet Down the Wire.
      *
@@ -433,6 +447,9 @@ class PointToPointNetDevice : public NetDevice
 
     Ptr<Packet> m_currentPkt; //!< Current packet processed
 
+    bool m_segmentationOffload;           //!< Split super-segments at transmit time
+    std::list<Ptr<Packet>> m_gsoSegments; //!< Wire packets left of the current super-segment
+
     /**
      * @brief PPP to Ethernet protocol number mapping
      * @param protocol A PPP protocol number
@@ -10,10 +10,12 @@
 #include "ns3/net-device-queue-interface.h"
 #include "ns3/point-to-point-channel.h"
 #include "ns3/point-to-point-net-device.h"
+#include "ns3/segmentation-offload.h"
 #include "ns3/simulator.h"
 #include "ns3/test.h"
 
 #include <string>
+#include <vector>
 
 using namespace ns3;
 
@@ -128,6 +130,150 @@ PointToPointTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * @brief Test the segmentation offload of the PointToPointNetDevice
+ *
+ * A super-segment is queued as one packet and split into wire packets at
+ * transmit time, which go out back to back, each with its own
+ * transmission time.
+ */
+class PointToPointSegmentationOffloadTest : public TestCase
+{
+  public:
+    /**
+     * @brief Create the test
+     */
+    PointToPointSegmentationOffloadTest();
+
+    /**
+     * @brief Run the test
+     */
+    void DoRun() override;
+
+    /**
+     * @brief Remove the segmenter registered by the test
+     */
+    void DoTeardown() override;
+
+  private:
+    /// Protocol of the test packets: the network stack registers no segmenter for IPv6
+    static constexpr uint16_t PROTOCOL = 0x86DD;
+
+    /**
+     * @brief Split a packet into payload chunks, with no header to replicate
+     *
+     * @param packet The super-segment.
+     * @param segmentSize The size of the chunks.
+     *
+     * @return The chunks.
+     */
+    static std::list<Ptr<Packet>> Split(Ptr<Packet> packet, uint16_t segmentSize);
+
+    /**
+     * @brief Callback function which records the received packets
+     *
+     * @param dev The receiving device.
+     * @param pkt The received packet.
+     * @param mode The protocol mode used.
+     * @param sender The sender address.
+     *
+     * @return A boolean indicating packet handled properly.
+     */
+    bool RxPacket(Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address& sender);
+
+    std::vector<uint32_t> m_rxSizes; //!< Sizes of the received packets
+    std::vector<Time> m_rxTimes;     //!< Reception times of the received packets
+};
+
+PointToPointSegmentationOffloadTest::PointToPointSegmentationOffloadTest()
+    : TestCase("PointToPoint segmentation offload")
+{
+}
+
+std::list<Ptr<Packet>>
+PointToPointSegmentationOffloadTest::Split(Ptr<Packet> packet, uint16_t segmentSize)
+{
+    std::list<Ptr<Packet>> segments;
+    for (uint32_t offset = 0; offset < packet->GetSize(); offset += segmentSize)
+    {
+        uint32_t size = std::min<uint32_t>(segmentSize, packet->GetSize() - offset);
+        segments.push_back(packet->CreateFragment(offset, size));
+    }
+    return segments;
+}
+
+bool
+PointToPointSegmentationOffloadTest::RxPacket(Ptr<NetDevice> dev,
+                                              Ptr<const Packet> pkt,
+                                              uint16_t mode,
+                                              const Address& sender)
+{
+    m_rxSizes.push_back(pkt->GetSize());
+    m_rxTimes.push_back(Simulator::Now());
+    return true;
+}
+
+void
+PointToPointSegmentationOffloadTest::DoRun()
+{
+    SegmentationOffload::Register(PROTOCOL,
+                                  MakeCallback(&PointToPointSegmentationOffloadTest::Split));
+
+    Ptr<Node> a = CreateObject<Node>();
+    Ptr<Node> b = CreateObject<Node>();
+    Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice>();
+    Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice>();
+    Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel>();
+    Ptr<Queue<Packet>> queue = CreateObject<DropTailQueue<Packet>>();
+
+    devA->Attach(channel);
+    devA->SetAddress(Mac48Address::Allocate());
+    devA->SetQueue(queue);
+    devA->SetDataRate(DataRate("8Mbps"));
+    devB->Attach(channel);
+    devB->SetAddress(Mac48Address::Allocate());
+    devB->SetQueue(CreateObject<DropTailQueue<Packet>>());
+
+    a->AddDevice(devA);
+    b->AddDevice(devB);
+
+    devB->SetReceiveCallback(
+        MakeCallback(&PointToPointSegmentationOffloadTest::RxPacket, this));
+
+    NS_TEST_ASSERT_MSG_EQ(devA->SupportsSegmentationOffload(), true, "Offload disabled");
+
+    Simulator::Schedule(Seconds(1), [devA]() {
+        Ptr<Packet> p = Create<Packet>(3500);
+        p->AddPacketTag(GsoTag(1000));
+        devA->Send(p, devA->GetBroadcast(), PROTOCOL);
+    });
+
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_EQ(queue->GetTotalReceivedPackets(), 1, "Super-segment split when queued");
+    NS_TEST_ASSERT_MSG_EQ(m_rxSizes.size(), 4, "Wrong number of wire packets");
+    std::vector<uint32_t> expected{1000, 1000, 1000, 500};
+    NS_TEST_EXPECT_MSG_EQ((m_rxSizes == expected), true, "Wrong wire packet sizes");
+
+    // PPP header of 2 bytes, no interframe gap and no propagation delay
+    DataRate rate("8Mbps");
+    Time start = Seconds(1);
+    for (uint32_t i = 0; i < m_rxTimes.size(); i++)
+    {
+        start += rate.CalculateBytesTxTime(expected[i] + 2);
+        NS_TEST_EXPECT_MSG_EQ(m_rxTimes[i], start, "Wire packet " << i << " not back to back");
+    }
+
+    Simulator::Destroy();
+}
+
+void
+PointToPointSegmentationOffloadTest::DoTeardown()
+{
+    // The segmenters are global: do not leak this one into the other tests
+    SegmentationOffload::Unregister(PROTOCOL);
+}
+
 /**
  * @brief TestSuite for PointToPoint module
  */
@@ -144,6 +290,7 @@ PointToPointTestSuite::PointToPointTestSuite()
     : TestSuite("devices-point-to-point", Type::UNIT)
 {
     AddTestCase(new PointToPointTest, TestCase::Duration::QUICK);
+    AddTestCase(new PointToPointSegmentationOffloadTest, TestCase::Duration::QUICK);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite; //!< The testsuite
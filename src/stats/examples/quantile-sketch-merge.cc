@@ -0,0 +1,85 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+//
+// Merges ns3::QuantileSketch CSV files, e.g. the RTT sketches written by
+// several runs of rack-example with different seeds, and prints a summary
+// of the merged distribution:
+//
+//     ./ns3 run "quantile-sketch-merge --files=rng1/rack/example/Traces/rtt.sketch,
+//                rng3/rack/example/Traces/rtt.sketch --cdf=rtt-cdf.plotme --output=rtt.sketch"
+//
+// The optional CDF file has one "value probability" line per bucket and can
+// be plotted directly with gnuplot. The optional output file holds the merged
+// sketch, so merges can be chained.
+//
+
+#include "ns3/core-module.h"
+#include "ns3/quantile-sketch.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("QuantileSketchMerge");
+
+int
+main(int argc, char* argv[])
+{
+    std::string files;
+    std::string cdf;
+    std::string output;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("files", "Comma separated sketch files to merge", files);
+    cmd.AddValue("cdf", "File to write the CDF of the merged sketch to", cdf);
+    cmd.AddValue("output", "File to write the merged sketch to", output);
+    cmd.Parse(argc, argv);
+
+    QuantileSketch merged;
+    bool first = true;
+    std::stringstream list(files);
+    std::string file;
+    while (std::getline(list, file, ','))
+    {
+        std::ifstream in(file);
+        QuantileSketch sketch;
+        NS_ABORT_MSG_IF(!in.is_open() || !sketch.DeserializeFromCsv(in),
+                        "Cannot read a sketch from " << file);
+        if (first)
+        {
+            merged = sketch;
+            first = false;
+        }
+        else
+        {
+            merged.Merge(sketch);
+        }
+    }
+    NS_ABORT_MSG_IF(first, "No sketch files given");
+
+    std::cout << "count " << merged.GetCount() << std::endl;
+    std::cout << "mean " << merged.GetMean() << std::endl;
+    std::cout << "min " << merged.GetMin() << std::endl;
+    for (double q : {0.5, 0.9, 0.95, 0.99, 0.999})
+    {
+        std::cout << "p" << q * 100 << " " << merged.GetQuantile(q) << std::endl;
+    }
+    std::cout << "max " << merged.GetMax() << std::endl;
+
+    if (!cdf.empty())
+    {
+        std::ofstream out(cdf);
+        merged.SerializeCdf(out);
+    }
+    if (!output.empty())
+    {
+        std::ofstream out(output);
+        merged.SerializeToCsv(out);
+    }
+    return 0;
+}
@@ -0,0 +1,369 @@
+//
+// SPDX-License-Identifier: GPL-2.0-only
+//
+
+#include "quantile-sketch.h"
+
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <string>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("QuantileSketch");
+
+namespace
+{
+
+/// Relative accuracy of the sketches built by the default constructor
+constexpr double DEFAULT_RELATIVE_ACCURACY = 0.01;
+
+} // namespace
+
+QuantileSketch::QuantileSketch(double relativeAccuracy)
+{
+    NS_ABORT_MSG_IF(relativeAccuracy <= 0 || relativeAccuracy >= 1,
+                    "Relative accuracy must be in (0, 1)");
+    m_relativeAccuracy = relativeAccuracy;
+    m_gamma = (1 + relativeAccuracy) / (1 - relativeAccuracy);
+    m_logGamma = std::log(m_gamma);
+    m_minIndexable = std::numeric_limits<double>::min() * m_gamma;
+    Clear();
+}
+
+QuantileSketch::QuantileSketch()
+    : QuantileSketch(DEFAULT_RELATIVE_ACCURACY)
+{
+}
+
+int32_t
+QuantileSketch::GetIndex(double value) const
+{
+    return static_cast<int32_t>(std::ceil(std::log(value) / m_logGamma));
+}
+
+double
+QuantileSketch::GetBucketValue(int32_t index) const
+{
+    // Bucket i holds (gamma^(i-1), gamma^i]; this value is within the
+    // relative accuracy of both ends.
+    return 2 * std::pow(m_gamma, index) / (m_gamma + 1);
+}
+
+void
+QuantileSketch::AddValue(double value)
+{
+    NS_LOG_FUNCTION(this << value);
+
+    if (value >= m_minIndexable)
+    {
+        m_positive[GetIndex(value)]++;
+    }
+    else if (value <= -m_minIndexable)
+    {
+        m_negative[GetIndex(-value)]++;
+    }
+    else
+    {
+        m_zeroCount++;
+    }
+
+    m_count++;
+    m_sum += value;
+    m_min = std::min(m_min, value);
+    m_max = std::max(m_max, value);
+}
+
+void
+QuantileSketch::AddTime(Time value)
+{
+    AddValue(value.GetSeconds());
+}
+
+void
+QuantileSketch::TraceSinkTime(Time oldValue, Time newValue)
+{
+    AddValue(newValue.GetSeconds());
+}
+
+void
+QuantileSketch::TraceSinkDelayAddress(const Time& delay, const Address& from)
+{
+    AddValue(delay.GetSeconds());
+}
+
+void
+QuantileSketch::Merge(const QuantileSketch& other)
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_IF(m_gamma != other.m_gamma, "Cannot merge sketches of different accuracy");
+
+    for (const auto& [index, count] : other.m_positive)
+    {
+        m_positive[index] += count;
+    }
+    for (const auto& [index, count] : other.m_negative)
+    {
+        m_negative[index] += count;
+    }
+    m_zeroCount += other.m_zeroCount;
+    m_count += other.m_count;
+    m_sum += other.m_sum;
+    m_min = std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+}
+
+double
+QuantileSketch::GetQuantile(double q) const
+{
+    NS_ASSERT_MSG(q >= 0 && q <= 1, "Quantile must be in [0, 1]");
+    if (m_count == 0)
+    {
+        return 0;
+    }
+
+    double rank = q * (m_count - 1);
+    if (rank == 0)
+    {
+        return m_min;
+    }
+    if (rank >= m_count - 1)
+    {
+        return m_max;
+    }
+
+    uint64_t seen = 0;
+    double value = 0;
+    bool found = false;
+
+    // Negative values, from the largest magnitude down
+    for (auto it = m_negative.rbegin(); it != m_negative.rend() && !found; ++it)
+    {
+        seen += it->second;
+        if (seen > rank)
+        {
+            value = -GetBucketValue(it->first);
+            found = true;
+        }
+    }
+    if (!found)
+    {
+        seen += m_zeroCount;
+        found = seen > rank;
+    }
+    for (auto it = m_positive.begin(); it != m_positive.end() && !found; ++it)
+    {
+        seen += it->second;
+        if (seen > rank)
+        {
+            value = GetBucketValue(it->first);
+            found = true;
+        }
+    }
+
+    return std::clamp(value, m_min, m_max);
+}
+
+uint64_t
+QuantileSketch::GetCount() const
+{
+    return m_count;
+}
+
+double
+QuantileSketch::GetMin() const
+{
+    return m_count ? m_min : 0;
+}
+
+double
+QuantileSketch::GetMax() const
+{
+    return m_count ? m_max : 0;
+}
+
+double
+QuantileSketch::GetMean() const
+{
+    return m_count ? m_sum / m_count : 0;
+}
+
+double
+QuantileSketch::GetRelativeAccuracy() const
+{
+    return m_relativeAccuracy;
+}
+
+uint32_t
+QuantileSketch::GetNBuckets() const
+{
+    return m_positive.size() + m_negative.size() + (m_zeroCount ? 1 : 0);
+}
+
+void
+QuantileSketch::Clear()
+{
+    m_positive.clear();
+    m_negative.clear();
+    m_zeroCount = 0;
+    m_count = 0;
+    m_sum = 0;
+    m_min = std::numeric_limits<double>::infinity();
+    m_max = -std::numeric_limits<double>::infinity();
+}
+
+void
+QuantileSketch::SerializeToCsv(std::ostream& os) const
+{
+    std::ios_base::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision(std::numeric_limits<double>::max_digits10);
+
+    os << "relativeAccuracy," << m_relativeAccuracy << "\n";
+    os << "count," << m_count << "\n";
+    os << "sum," << m_sum << "\n";
+    os << "min," << GetMin() << "\n";
+    os << "max," << GetMax() << "\n";
+    os << "zero," << m_zeroCount << "\n";
+    for (const auto& [index, count] : m_negative)
+    {
+        os << "negative," << index << "," << count << "\n";
+    }
+    for (const auto& [index, count] : m_positive)
+    {
+        os << "positive," << index << "," << count << "\n";
+    }
+
+    os.precision(precision);
+    os.flags(flags);
+}
+
+bool
+QuantileSketch::DeserializeFromCsv(std::istream& is)
+{
+    NS_LOG_FUNCTION(this);
+
+    QuantileSketch sketch;
+    bool haveAccuracy = false;
+    uint64_t count = 0;
+    double min = 0;
+    double max = 0;
+    std::string line;
+
+    while (std::getline(is, line))
+    {
+        if (line.empty())
+        {
+            continue;
+        }
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::istringstream fields(line);
+        std::string key;
+        fields >> key;
+
+        if (key == "relativeAccuracy")
+        {
+            double accuracy;
+            if (!(fields >> accuracy) || accuracy <= 0 || accuracy >= 1)
+            {
+                return false;
+            }
+            sketch = QuantileSketch(accuracy);
+            haveAccuracy = true;
+        }
+        else if (!haveAccuracy)
+        {
+            return false;
+        }
+        else if (key == "count")
+        {
+            fields >> count;
+        }
+        else if (key == "sum")
+        {
+            fields >> sketch.m_sum;
+        }
+        else if (key == "min")
+        {
+            fields >> min;
+        }
+        else if (key == "max")
+        {
+            fields >> max;
+        }
+        else if (key == "zero")
+        {
+            fields >> sketch.m_zeroCount;
+            sketch.m_count += sketch.m_zeroCount;
+        }
+        else if (key == "positive" || key == "negative")
+        {
+            int32_t index;
+            uint64_t n;
+            if (!(fields >> index >> n))
+            {
+                return false;
+            }
+            (key == "positive" ? sketch.m_positive : sketch.m_negative)[index] += n;
+            sketch.m_count += n;
+        }
+        else
+        {
+            return false;
+        }
+
+        if (fields.fail())
+        {
+            return false;
+        }
+    }
+
+    if (!haveAccuracy || sketch.m_count != count)
+    {
+        return false;
+    }
+    if (count > 0)
+    {
+        sketch.m_min = min;
+        sketch.m_max = max;
+    }
+    *this = sketch;
+    return true;
+}
+
+void
+QuantileSketch::SerializeCdf(std::ostream& os) const
+{
+    if (m_count == 0)
+    {
+        return;
+    }
+
+    uint64_t seen = 0;
+    for (auto it = m_negative.rbegin(); it != m_negative.rend(); ++it)
+    {
+        seen += it->second;
+        os << std::max(-GetBucketValue(it->first), m_min) << " "
+           << static_cast<double>(seen) / m_count << "\n";
+    }
+    if (m_zeroCount)
+    {
+        seen += m_zeroCount;
+        os << 0 << " " << static_cast<double>(seen) / m_count << "\n";
+    }
+    for (const auto& [index, count] : m_positive)
+    {
+        seen += count;
+        os << std::min(GetBucketValue(index), m_max) << " " << static_cast<double>(seen) / m_count
+           << "\n";
+    }
+}
+
+} // namespace ns3
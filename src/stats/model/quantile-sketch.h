@@ -0,0 +1,186 @@
+//
+// SPDX-License-Identifier: GPL-2.0-only
+//
+
+#ifndef NS3_QUANTILE_SKETCH_H
+#define NS3_QUANTILE_SKETCH_H
+
+#include "ns3/nstime.h"
+
+#include <istream>
+#include <map>
+#include <ostream>
+#include <stdint.h>
+
+namespace ns3
+{
+
+class Address;
+
+/**
+ * @ingroup stats
+ * @brief Mergeable streaming quantile sketch with bounded relative error.
+ *
+ * This is a DDSketch (Masson, Rim and Lee, VLDB 2019). A value \f$v > 0\f$
+ * is counted in the logarithmic bucket
+ * \f$i = \lceil \log_\gamma v \rceil\f$ with
+ * \f$\gamma = (1 + \alpha) / (1 - \alpha)\f$, and every quantile is
+ * estimated within a relative error of \f$\alpha\f$ of the exact value.
+ * Negative values use a mirrored set of buckets; values whose magnitude is
+ * below the smallest indexable value are counted as zero.
+ *
+ * Memory depends only on the dynamic range of the data (about
+ * \f$\ln(v_{max}/v_{min}) / (2\alpha)\f$ buckets), not on the number of
+ * samples, so a sketch can replace a per-sample trace file. Sketches with
+ * the same accuracy can be merged without loss, e.g. to aggregate the
+ * samples of several clients or of several simulation runs.
+ *
+ * Time values are recorded in seconds. A sketch can be attached directly to
+ * a TracedValue<Time> trace source, or to the delay trace sources of the
+ * applications, with
+ * \code
+ *   socket->TraceConnectWithoutContext("RTT",
+ *                                      MakeCallback(&QuantileSketch::TraceSinkTime, &sketch));
+ *   client->TraceConnectWithoutContext(
+ *       "RxRtt",
+ *       MakeCallback(&QuantileSketch::TraceSinkDelayAddress, &sketch));
+ * \endcode
+ *
+ * The CSV produced by SerializeToCsv() holds the complete sketch and can be
+ * read back with DeserializeFromCsv() to merge the results of separate runs.
+ */
+class QuantileSketch
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param relativeAccuracy the relative accuracy \f$\alpha\f$, in (0, 1)
+     */
+    QuantileSketch(double relativeAccuracy);
+    QuantileSketch();
+
+    /**
+     * @brief Add a value to the sketch
+     * @param value the value to add
+     */
+    void AddValue(double value);
+
+    /**
+     * @brief Add a time value, in seconds, to the sketch
+     * @param value the value to add
+     */
+    void AddTime(Time value);
+
+    /**
+     * @brief Trace sink for a TracedValue<Time>: add the new value, in seconds
+     * @param oldValue the previous value, ignored
+     * @param newValue the new value
+     */
+    void TraceSinkTime(Time oldValue, Time newValue);
+
+    /**
+     * @brief Trace sink for the (delay, address) trace sources of the
+     * applications, e.g., RxRtt: add the delay, in seconds
+     * @param delay the delay
+     * @param from the address of the peer, ignored
+     */
+    void TraceSinkDelayAddress(const Time& delay, const Address& from);
+
+    /**
+     * @brief Merge the content of another sketch into this one
+     *
+     * Both sketches must have the same relative accuracy.
+     *
+     * @param other the sketch to merge
+     */
+    void Merge(const QuantileSketch& other);
+
+    /**
+     * @brief Estimate a quantile
+     * @param q the quantile, in [0, 1]
+     * @return the estimated value, or 0 if the sketch is empty
+     */
+    double GetQuantile(double q) const;
+
+    /**
+     * @return the number of values added
+     */
+    uint64_t GetCount() const;
+    /**
+     * @return the smallest value added
+     */
+    double GetMin() const;
+    /**
+     * @return the largest value added
+     */
+    double GetMax() const;
+    /**
+     * @return the mean of the values added
+     */
+    double GetMean() const;
+    /**
+     * @return the relative accuracy of the sketch
+     */
+    double GetRelativeAccuracy() const;
+    /**
+     * @return the number of non-empty buckets
+     */
+    uint32_t GetNBuckets() const;
+
+    /**
+     * Clear the sketch content.
+     */
+    void Clear();
+
+    /**
+     * @brief Serialize the whole sketch in CSV format
+     * @param os the output stream
+     */
+    void SerializeToCsv(std::ostream& os) const;
+
+    /**
+     * @brief Replace the content of the sketch with one written by SerializeToCsv()
+     * @param is the input stream
+     * @return false if the input is not a valid sketch
+     */
+    bool DeserializeFromCsv(std::istream& is);
+
+    /**
+     * @brief Write a CDF of the data, one "value probability" line per bucket
+     *
+     * The format matches the .plotme files used with gnuplot.
+     *
+     * @param os the output stream
+     */
+    void SerializeCdf(std::ostream& os) const;
+
+  private:
+    /**
+     * @brief Get the bucket of a positive value
+     * @param value the value
+     * @return the bucket index
+     */
+    int32_t GetIndex(double value) const;
+    /**
+     * @brief Get the representative value of a bucket
+     * @param index the bucket index
+     * @return the value
+     */
+    double GetBucketValue(int32_t index) const;
+
+    double m_relativeAccuracy;              //!< Relative accuracy
+    double m_gamma;                         //!< Bucket growth factor
+    double m_logGamma;                      //!< Natural logarithm of m_gamma
+    double m_minIndexable;                  //!< Smallest magnitude not counted as zero
+    std::map<int32_t, uint64_t> m_positive; //!< Buckets of positive values
+    std::map<int32_t, uint64_t> m_negative; //!< Buckets of negative values, by magnitude
+    uint64_t m_zeroCount;                   //!< Number of values counted as zero
+    uint64_t m_count;                       //!< Number of values
+    double m_sum;                           //!< Sum of the values
+    double m_min;                           //!< Smallest value
+    double m_max;                           //!< Largest value
+};
+
+} // namespace ns3
+
+#endif /* NS3_QUANTILE_SKETCH_H */
@@ -0,0 +1,212 @@
+//
+// SPDX-License-Identifier: GPL-2.0-only
+//
+
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/quantile-sketch.h"
+#include "ns3/test.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/traced-value.h"
+#include "ns3/type-id.h"
+
+#include <cmath>
+#include <sstream>
+
+using namespace ns3;
+
+/**
+ * @ingroup stats-tests
+ *
+ * @brief QuantileSketch Test
+ */
+class QuantileSketchTestCase : public ns3::TestCase
+{
+  public:
+    QuantileSketchTestCase();
+    void DoRun() override;
+};
+
+QuantileSketchTestCase::QuantileSketchTestCase()
+    : ns3::TestCase("QuantileSketch")
+{
+}
+
+void
+QuantileSketchTestCase::DoRun()
+{
+    const double alpha = 0.01;
+
+    // Quantiles of 1..10000 are within the relative accuracy
+    QuantileSketch s0(alpha);
+    {
+        for (int i = 1; i <= 10000; i++)
+        {
+            s0.AddValue(i);
+        }
+
+        NS_TEST_EXPECT_MSG_EQ(s0.GetCount(), 10000, "");
+        NS_TEST_EXPECT_MSG_EQ_TOL(s0.GetMean(), 5000.5, 1e-6, "");
+        NS_TEST_EXPECT_MSG_EQ_TOL(s0.GetQuantile(0), 1, 1e-9, "Minimum is exact");
+        NS_TEST_EXPECT_MSG_EQ_TOL(s0.GetQuantile(1), 10000, 1e-9, "Maximum is exact");
+        for (double q : {0.1, 0.25, 0.5, 0.9, 0.99})
+        {
+            double exact = 1 + std::floor(q * 9999);
+            NS_TEST_EXPECT_MSG_EQ_TOL(s0.GetQuantile(q), exact, alpha * exact, "Quantile " << q);
+        }
+        NS_TEST_EXPECT_MSG_LT(s0.GetNBuckets(), 500, "Buckets depend on the range, not the count");
+    }
+
+    // Merging is equivalent to adding all the values to one sketch
+    {
+        QuantileSketch all(alpha);
+        QuantileSketch odd(alpha);
+        QuantileSketch even(alpha);
+        for (int i = 1; i <= 10000; i++)
+        {
+            all.AddTime(MilliSeconds(i));
+            (i % 2 ? odd : even).AddTime(MilliSeconds(i));
+        }
+        odd.Merge(even);
+
+        NS_TEST_EXPECT_MSG_EQ(odd.GetCount(), all.GetCount(), "");
+        NS_TEST_EXPECT_MSG_EQ(odd.GetNBuckets(), all.GetNBuckets(), "");
+        NS_TEST_EXPECT_MSG_EQ_TOL(odd.GetMax(), 10, 1e-9, "Time values are in seconds");
+        for (double q : {0.0, 0.5, 0.99, 1.0})
+        {
+            NS_TEST_EXPECT_MSG_EQ_TOL(odd.GetQuantile(q),
+                                      all.GetQuantile(q),
+                                      1e-12,
+                                      "Quantile " << q);
+        }
+    }
+
+    // Zero and negative values
+    {
+        QuantileSketch s1(alpha);
+        for (int i = -100; i <= 100; i++)
+        {
+            s1.AddValue(i);
+        }
+        NS_TEST_EXPECT_MSG_EQ_TOL(s1.GetQuantile(0.5), 0, 1e-9, "");
+        NS_TEST_EXPECT_MSG_EQ_TOL(s1.GetQuantile(0.25), -50, 0.5 + alpha * 50, "");
+        NS_TEST_EXPECT_MSG_EQ_TOL(s1.GetQuantile(0), -100, 1e-9, "");
+    }
+
+    // A CSV round trip keeps the whole sketch
+    {
+        std::stringstream csv;
+        s0.SerializeToCsv(csv);
+        QuantileSketch s2;
+        NS_TEST_ASSERT_MSG_EQ(s2.DeserializeFromCsv(csv), true, "Valid sketch not read back");
+        NS_TEST_EXPECT_MSG_EQ_TOL(s2.GetRelativeAccuracy(), alpha, 1e-12, "");
+        NS_TEST_EXPECT_MSG_EQ(s2.GetCount(), s0.GetCount(), "");
+        NS_TEST_EXPECT_MSG_EQ(s2.GetNBuckets(), s0.GetNBuckets(), "");
+        NS_TEST_EXPECT_MSG_EQ_TOL(s2.GetMean(), s0.GetMean(), 1e-9, "");
+        NS_TEST_EXPECT_MSG_EQ_TOL(s2.GetQuantile(0.9), s0.GetQuantile(0.9), 1e-9, "");
+
+        std::stringstream bad("count,1\n");
+        NS_TEST_EXPECT_MSG_EQ(s2.DeserializeFromCsv(bad), false, "Missing accuracy accepted");
+        NS_TEST_EXPECT_MSG_EQ(s2.GetCount(), s0.GetCount(), "Failed read changed the sketch");
+    }
+}
+
+/**
+ * @ingroup stats-tests
+ *
+ * @brief Object with a TracedValue<Time> trace source.
+ */
+class QuantileSketchTimeEmitter : public Object
+{
+  public:
+    /**
+     * @brief Get the type ID.
+     * @return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * @brief Change the traced value.
+     * @param value the new value
+     */
+    void Set(Time value)
+    {
+        m_value = value;
+    }
+
+  private:
+    TracedValue<Time> m_value; //!< Traced value
+};
+
+TypeId
+QuantileSketchTimeEmitter::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("QuantileSketchTimeEmitter")
+            .SetParent<Object>()
+            .AddTraceSource("Value",
+                            "The traced value",
+                            MakeTraceSourceAccessor(&QuantileSketchTimeEmitter::m_value),
+                            "ns3::TracedValueCallback::Time");
+    return tid;
+}
+
+/**
+ * @ingroup stats-tests
+ *
+ * @brief Check that a QuantileSketch can be connected to a Time trace source
+ */
+class QuantileSketchTraceTestCase : public ns3::TestCase
+{
+  public:
+    QuantileSketchTraceTestCase();
+    void DoRun() override;
+};
+
+QuantileSketchTraceTestCase::QuantileSketchTraceTestCase()
+    : ns3::TestCase("QuantileSketch as a TracedValue<Time> sink")
+{
+}
+
+void
+QuantileSketchTraceTestCase::DoRun()
+{
+    QuantileSketch sketch(0.01);
+    Ptr<QuantileSketchTimeEmitter> emitter = CreateObject<QuantileSketchTimeEmitter>();
+    bool connected =
+        emitter->TraceConnectWithoutContext("Value",
+                                            MakeCallback(&QuantileSketch::TraceSinkTime, &sketch));
+    NS_TEST_ASSERT_MSG_EQ(connected, true, "Cannot connect the sketch to the trace source");
+
+    for (int i = 1; i <= 100; i++)
+    {
+        emitter->Set(MilliSeconds(i));
+    }
+    // An unchanged value does not fire the trace
+    emitter->Set(MilliSeconds(100));
+
+    NS_TEST_EXPECT_MSG_EQ(sketch.GetCount(), 100, "Wrong number of traced values");
+    NS_TEST_EXPECT_MSG_EQ_TOL(sketch.GetMin(), 0.001, 1e-12, "The new values are not recorded");
+    NS_TEST_EXPECT_MSG_EQ_TOL(sketch.GetMax(), 0.1, 1e-12, "The new values are not recorded");
+    NS_TEST_EXPECT_MSG_EQ_TOL(sketch.GetQuantile(0.5), 0.050, 0.050 * 0.01, "Wrong median");
+}
+
+/**
+ * @ingroup stats-tests
+ *
+ * @brief QuantileSketch TestSuite
+ */
+class QuantileSketchTestSuite : public TestSuite
+{
+  public:
+    QuantileSketchTestSuite();
+};
+
+QuantileSketchTestSuite::QuantileSketchTestSuite()
+    : TestSuite("quantile-sketch", Type::UNIT)
+{
+    AddTestCase(new QuantileSketchTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new QuantileSketchTraceTestCase, TestCase::Duration::QUICK);
+}
+
+static QuantileSketchTestSuite g_QuantileSketchTestSuite; //!< Static variable for test initialization
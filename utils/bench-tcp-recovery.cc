@@ -0,0 +1,544 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// This program benchmarks the TCP loss recovery code: the SACK scoreboard
+// (TcpTxBuffer) and RACK loss detection, under scripted ACK patterns.
+//
+// The "buffer" benchmark drives a TcpTxBuffer and a TcpRack directly, with
+// a minimal ACK-clocked sender, a bottleneck that serializes segments and a
+// receiver that generates one ACK (with up to three SACK blocks and D-SACK)
+// per segment. The data path follows one of these patterns:
+//
+//   inorder  no reordering and no loss
+//   reorder  every --every-th segment is delivered --depth segments late
+//   loss     every --every-th new segment is dropped
+//
+// It reports events/s, ACKs/s and the mean time per call of the buffer
+// operations on the ACK and send paths: Update (SACK processing),
+// DetectRackLoss, DiscardUpTo and CopyFromSequence (the segment copy done
+// for every transmission by TcpSocketBase::SendPendingData).
+//
+// The "socket" benchmark runs a full TcpSocketBase over a point-to-point
+// dumbbell, optionally through a ns3::ReorderQueue, and reports events/s
+// and ACKs/s of the whole stack.
+//
+// Both benchmarks also report the heap allocations (operator new calls) per
+// MB of data transferred.
+//
+// Sample usage:  ./ns3 run 'bench-tcp-recovery --window=500 --acks=200000 --pattern=loss'
+
+#include "ns3/applications-module.h"
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <new>
+#include <string>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("BenchTcpRecovery");
+
+/// Number of calls to operator new in the whole program
+static uint64_t g_allocations = 0;
+
+void*
+operator new(std::size_t size)
+{
+    g_allocations++;
+    if (void* p = std::malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void
+operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void
+operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+/**
+ * Print the heap allocations per MB transferred.
+ * @param allocations the number of allocations
+ * @param bytes the bytes transferred
+ */
+static void
+PrintAllocations(uint64_t allocations, uint64_t bytes)
+{
+    std::cout << "  " << allocations << " heap allocations, " << std::fixed
+              << std::setprecision(0) << (bytes ? allocations / (bytes / 1e6) : 0)
+              << " per MB transferred" << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+}
+
+/** Accumulated wall clock time and calls of one function. */
+struct FunctionTimer
+{
+    std::chrono::steady_clock::duration total{0}; //!< Time spent in the function
+    uint64_t calls{0};                            //!< Number of calls
+
+    /**
+     * Time one call.
+     * @param f the call
+     * @returns the result of the call
+     */
+    template <typename F>
+    auto Measure(F&& f)
+    {
+        auto start = std::chrono::steady_clock::now();
+        struct Stop
+        {
+            FunctionTimer* t;                            //!< The timer
+            std::chrono::steady_clock::time_point start; //!< Start of the call
+            ~Stop()
+            {
+                t->total += std::chrono::steady_clock::now() - start;
+                t->calls++;
+            }
+        } stop{this, start};
+        return f();
+    }
+
+    /**
+     * Print the timer.
+     * @param name the function name
+     */
+    void Print(const std::string& name) const
+    {
+        double ns = std::chrono::duration<double, std::nano>(total).count();
+        std::cout << "  " << std::left << std::setw(18) << name << std::right << std::setw(12)
+                  << calls << " calls " << std::setw(10) << std::fixed << std::setprecision(1)
+                  << (calls ? ns / calls : 0) << " ns/call " << std::setw(8)
+                  << std::setprecision(3) << ns / 1e9 << " s" << std::endl;
+    }
+};
+
+/**
+ * Drives a TcpTxBuffer and a TcpRack through a scripted data and ACK
+ * pattern.
+ */
+class RecoveryBench
+{
+  public:
+    /** Benchmark configuration. */
+    struct Config
+    {
+        std::string pattern{"reorder"};     //!< inorder, reorder or loss
+        uint32_t window{100};               //!< Window, in segments
+        uint32_t every{10};                 //!< Period of the reordered or lost segments
+        uint32_t depth{3};                  //!< Reordering delay, in segments
+        uint64_t acks{100000};              //!< Number of ACKs to process
+        uint32_t segmentSize{1000};         //!< Segment size
+        Time oneWayDelay{MilliSeconds(10)}; //!< One-way propagation delay
+        Time txTime{MicroSeconds(80)};      //!< Bottleneck serialization time
+    };
+
+    /**
+     * Constructor
+     * @param config the configuration
+     */
+    RecoveryBench(const Config& config);
+
+    /** Run the benchmark and print the results. */
+    void Run();
+
+  private:
+    /** Fill the window, retransmitting lost segments first. */
+    void SendPending();
+    /**
+     * A data segment reaches the receiver.
+     * @param seq first sequence number
+     * @param end sequence number past the segment
+     */
+    void DataArrival(SequenceNumber32 seq, SequenceNumber32 end);
+    /**
+     * An ACK reaches the sender.
+     * @param ack cumulative ACK
+     * @param sack SACK blocks
+     */
+    void AckArrival(SequenceNumber32 ack, TcpOptionSack::SackList sack);
+    /** Run RACK loss detection and (re)arm its timer. */
+    void DetectLoss();
+    /** @returns the receiver window */
+    uint32_t GetRWnd() const;
+
+    Config m_config;                                    //!< Configuration
+    Ptr<TcpTxBuffer> m_txBuf;                           //!< Sender scoreboard
+    Ptr<TcpRack> m_rack;                                //!< RACK state
+    Ptr<TcpRttSampler> m_rttSampler;                    //!< RTT samples fed to RACK
+    EventId m_rackTimer;                                //!< RACK reordering timer
+    Time m_linkFree;                                    //!< Time the bottleneck becomes idle
+    uint64_t m_newSegments{0};                          //!< New segments sent
+    uint64_t m_retransmits{0};                          //!< Segments retransmitted
+    uint64_t m_acks{0};                                 //!< ACKs processed
+    SequenceNumber32 m_rcvNxt;                          //!< Receiver cumulative ACK point
+    std::map<SequenceNumber32, SequenceNumber32> m_ooo; //!< Receiver out-of-order ranges
+    FunctionTimer m_update;                             //!< TcpTxBuffer::Update
+    FunctionTimer m_detect;                             //!< TcpTxBuffer::DetectRackLoss
+    FunctionTimer m_discard;                            //!< TcpTxBuffer::DiscardUpTo
+    FunctionTimer m_copy;                               //!< TcpTxBuffer::CopyFromSequence
+};
+
+RecoveryBench::RecoveryBench(const Config& config)
+    : m_config(config),
+      m_rcvNxt(1)
+{
+    NS_ABORT_MSG_IF(config.pattern != "inorder" && config.pattern != "reorder" &&
+                        config.pattern != "loss",
+                    "Unknown pattern " << config.pattern);
+    NS_ABORT_MSG_IF(config.every < 2, "--every must be at least 2");
+
+    m_txBuf = CreateObject<TcpTxBuffer>();
+    m_txBuf->SetRWndCallback(MakeCallback(&RecoveryBench::GetRWnd, this));
+    m_txBuf->SetSegmentSize(config.segmentSize);
+    m_txBuf->SetDupAckThresh(3);
+    m_txBuf->SetSackEnabled(true);
+    m_txBuf->SetMaxBufferSize(4 * config.window * config.segmentSize);
+    m_txBuf->SetHeadSequence(m_rcvNxt);
+    m_rack = CreateObject<TcpRack>();
+    m_rttSampler = CreateObject<TcpRttSampler>();
+    m_rttSampler->SetEstimator(CreateObject<RttMeanDeviation>());
+    m_rttSampler->Subscribe(MakeCallback(&TcpRack::UpdateRtt, m_rack));
+}
+
+uint32_t
+RecoveryBench::GetRWnd() const
+{
+    return std::numeric_limits<uint32_t>::max();
+}
+
+void
+RecoveryBench::SendPending()
+{
+    const uint32_t mss = m_config.segmentSize;
+    while (m_txBuf->BytesInFlight() < m_config.window * mss)
+    {
+        if (m_txBuf->Available() >= mss)
+        {
+            m_txBuf->Add(Create<Packet>(m_txBuf->Available() / mss * mss));
+        }
+
+        SequenceNumber32 seq;
+        SequenceNumber32 seqHigh;
+        if (!m_txBuf->NextSeg(&seq, &seqHigh, true))
+        {
+            break;
+        }
+        TcpTxItem* item = m_copy.Measure([&] { return m_txBuf->CopyFromSequence(mss, seq); });
+        if (item == nullptr)
+        {
+            break;
+        }
+        uint32_t size = item->GetSeqSize();
+        bool retrans = item->IsRetrans();
+
+        m_linkFree = std::max(m_linkFree, Simulator::Now()) + m_config.txTime;
+        Time arrival = m_linkFree + m_config.oneWayDelay;
+        if (!retrans)
+        {
+            ++m_newSegments;
+            if (m_newSegments % m_config.every == 0)
+            {
+                if (m_config.pattern == "loss")
+                {
+                    continue;
+                }
+                if (m_config.pattern == "reorder")
+                {
+                    arrival += m_config.txTime * m_config.depth;
+                }
+            }
+        }
+        else
+        {
+            ++m_retransmits;
+        }
+        Simulator::Schedule(arrival - Simulator::Now(),
+                            &RecoveryBench::DataArrival,
+                            this,
+                            seq,
+                            seq + size);
+    }
+}
+
+void
+RecoveryBench::DataArrival(SequenceNumber32 seq, SequenceNumber32 end)
+{
+    TcpOptionSack::SackList sack;
+    if (end <= m_rcvNxt)
+    {
+        // Spurious retransmission: report it with a D-SACK block
+        sack.emplace_back(seq, end);
+    }
+    else if (seq <= m_rcvNxt)
+    {
+        m_rcvNxt = end;
+        for (auto it = m_ooo.begin(); it != m_ooo.end() && it->first <= m_rcvNxt;)
+        {
+            m_rcvNxt = std::max(m_rcvNxt, it->second);
+            it = m_ooo.erase(it);
+        }
+    }
+    else
+    {
+        // Merge the segment with the out-of-order ranges it touches
+        auto it = m_ooo.lower_bound(seq);
+        if (it != m_ooo.begin() && std::prev(it)->second >= seq)
+        {
+            --it;
+        }
+        SequenceNumber32 start = seq;
+        SequenceNumber32 stop = end;
+        while (it != m_ooo.end() && it->first <= stop)
+        {
+            start = std::min(start, it->first);
+            stop = std::max(stop, it->second);
+            it = m_ooo.erase(it);
+        }
+        m_ooo[start] = stop;
+        sack.emplace_back(start, stop);
+    }
+
+    // RFC 2018: the most recent block first, then the highest other ones
+    for (auto it = m_ooo.rbegin(); it != m_ooo.rend() && sack.size() < 3; ++it)
+    {
+        if (sack.empty() || it->first != sack.front().first)
+        {
+            sack.emplace_back(it->first, it->second);
+        }
+    }
+
+    Simulator::Schedule(m_config.oneWayDelay, &RecoveryBench::AckArrival, this, m_rcvNxt, sack);
+}
+
+void
+RecoveryBench::AckArrival(SequenceNumber32 ack, TcpOptionSack::SackList sack)
+{
+    ++m_acks;
+    if (m_acks >= m_config.acks)
+    {
+        Simulator::Stop();
+    }
+
+    uint32_t sacked = 0;
+    if (!sack.empty())
+    {
+        sacked = m_update.Measure([&] { return m_txBuf->Update(sack); });
+    }
+
+    if (ack >= m_txBuf->HeadSequence())
+    {
+        TcpTxItem item;
+        SequenceNumber32 end = sacked ? m_txBuf->GetHighestSacked() : ack;
+        m_txBuf->GetPacketInfo(end, &item);
+        if (!item.GetLastSent().IsZero())
+        {
+            Time rtt = Simulator::Now() - item.GetLastSent();
+            m_rttSampler->AddSample(item.IsRetrans() ? Time(0) : rtt, rtt);
+            m_rack->UpdateStats(static_cast<uint32_t>(Simulator::Now().GetMilliSeconds()),
+                                item.IsRetrans(),
+                                item.GetLastSent(),
+                                end,
+                                m_txBuf->TailSequence(),
+                                rtt);
+        }
+    }
+
+    DetectLoss();
+
+    if (ack > m_txBuf->HeadSequence())
+    {
+        m_discard.Measure([&] { m_txBuf->DiscardUpTo(ack); });
+    }
+
+    SendPending();
+}
+
+void
+RecoveryBench::DetectLoss()
+{
+    Time timeout{0};
+    m_detect.Measure([&] { m_txBuf->DetectRackLoss(m_rack, &timeout); });
+    m_rackTimer.Cancel();
+    if (timeout.IsStrictlyPositive())
+    {
+        m_rackTimer = Simulator::Schedule(timeout, [this]() {
+            DetectLoss();
+            SendPending();
+        });
+    }
+}
+
+void
+RecoveryBench::Run()
+{
+    Simulator::ScheduleNow(&RecoveryBench::SendPending, this);
+
+    SystemWallClockMs timer;
+    uint64_t events = Simulator::GetEventCount();
+    uint64_t allocations = g_allocations;
+    timer.Start();
+    Simulator::Run();
+    double wall = timer.End() / 1000.0;
+    allocations = g_allocations - allocations;
+    events = Simulator::GetEventCount() - events;
+    m_rackTimer.Cancel();
+    Simulator::Destroy();
+
+    std::cout << "buffer benchmark, pattern " << m_config.pattern << ", window "
+              << m_config.window << " segments" << std::endl;
+    std::cout << "  " << m_acks << " ACKs, " << m_newSegments << " new segments, "
+              << m_retransmits << " retransmissions, " << events << " events in " << wall
+              << " s" << std::endl;
+    std::cout << "  " << std::fixed << std::setprecision(0) << events / wall << " events/s, "
+              << m_acks / wall << " ACKs/s" << std::endl;
+    m_update.Print("Update");
+    m_detect.Print("DetectRackLoss");
+    m_discard.Print("DiscardUpTo");
+    m_copy.Print("CopyFromSequence");
+    std::cout.unsetf(std::ios::fixed);
+    PrintAllocations(allocations, m_newSegments * m_config.segmentSize);
+}
+
+/**
+ * Run a bulk transfer through the full TCP stack.
+ *
+ * @param simTime simulated time
+ * @param reorder use a ReorderQueue at the bottleneck
+ * @param rack enable RACK
+ * @param tlp enable TLP
+ */
+static void
+RunSocketBench(Time simTime, bool reorder, bool rack, bool tlp)
+{
+    Config::SetDefault("ns3::TcpL4Protocol::SocketType", StringValue("ns3::TcpLinuxReno"));
+    Config::SetDefault("ns3::TcpSocket::SndBufSize", UintegerValue(1 << 20));
+    Config::SetDefault("ns3::TcpSocket::RcvBufSize", UintegerValue(1 << 20));
+    Config::SetDefault("ns3::TcpSocket::SegmentSize", UintegerValue(1000));
+    Config::SetDefault("ns3::TcpSocketBase::Sack", BooleanValue(true));
+    Config::SetDefault("ns3::TcpSocketBase::Dsack", BooleanValue(rack));
+    Config::SetDefault("ns3::TcpSocketBase::Rack", BooleanValue(rack));
+    Config::SetDefault("ns3::TcpSocketBase::Tlp", BooleanValue(tlp));
+
+    NodeContainer nodes;
+    nodes.Create(3);
+    PointToPointHelper access;
+    access.SetDeviceAttribute("DataRate", StringValue("100Mbps"));
+    access.SetChannelAttribute("Delay", StringValue("1ms"));
+    PointToPointHelper bottleneck;
+    bottleneck.SetDeviceAttribute("DataRate", StringValue("10Mbps"));
+    bottleneck.SetChannelAttribute("Delay", StringValue("10ms"));
+    if (reorder)
+    {
+        bottleneck.SetQueue("ns3::ReorderQueue");
+    }
+    NetDeviceContainer left = access.Install(nodes.Get(0), nodes.Get(1));
+    NetDeviceContainer right = bottleneck.Install(nodes.Get(1), nodes.Get(2));
+
+    InternetStackHelper stack;
+    stack.Install(nodes);
+    Ipv4AddressHelper address("10.0.0.0", "255.255.255.0");
+    address.Assign(left);
+    address.NewNetwork();
+    Ipv4InterfaceContainer rightIf = address.Assign(right);
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+
+    uint16_t port = 50000;
+    PacketSinkHelper sink("ns3::TcpSocketFactory", InetSocketAddress(Ipv4Address::GetAny(), port));
+    ApplicationContainer sinkApp = sink.Install(nodes.Get(2));
+    sinkApp.Start(Seconds(0));
+    BulkSendHelper source("ns3::TcpSocketFactory", InetSocketAddress(rightIf.GetAddress(1), port));
+    source.SetAttribute("MaxBytes", UintegerValue(0));
+    ApplicationContainer sourceApp = source.Install(nodes.Get(0));
+    sourceApp.Start(Seconds(0));
+
+    uint64_t acks = 0;
+    Simulator::Schedule(MilliSeconds(1), [&acks]() {
+        Config::ConnectWithoutContext(
+            "/NodeList/0/$ns3::TcpL4Protocol/SocketList/0/Rx",
+            Callback<void, Ptr<const Packet>, const TcpHeader&, Ptr<const TcpSocketBase>>(
+                [&acks](Ptr<const Packet>, const TcpHeader& h, Ptr<const TcpSocketBase>) {
+                    acks += (h.GetFlags() & TcpHeader::ACK) ? 1 : 0;
+                }));
+    });
+
+    SystemWallClockMs timer;
+    uint64_t events = Simulator::GetEventCount();
+    uint64_t allocations = g_allocations;
+    timer.Start();
+    Simulator::Stop(simTime);
+    Simulator::Run();
+    double wall = timer.End() / 1000.0;
+    allocations = g_allocations - allocations;
+    events = Simulator::GetEventCount() - events;
+    uint64_t received = DynamicCast<PacketSink>(sinkApp.Get(0))->GetTotalRx();
+    Simulator::Destroy();
+
+    std::cout << "socket benchmark, " << (reorder ? "ReorderQueue" : "DropTailQueue")
+              << ", RACK " << (rack ? "on" : "off") << ", TLP " << (tlp ? "on" : "off")
+              << std::endl;
+    std::cout << "  " << acks << " ACKs, " << events << " events in " << wall << " s"
+              << std::endl;
+    std::cout << "  " << std::fixed << std::setprecision(0) << events / wall << " events/s, "
+              << acks / wall << " ACKs/s" << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+    PrintAllocations(allocations, received);
+}
+
+int
+main(int argc, char* argv[])
+{
+    RecoveryBench::Config config;
+    std::string bench = "buffer";
+    double simTime = 10;
+    bool reorder = true;
+    bool rack = true;
+    bool tlp = false;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("bench", "Benchmark to run: buffer, socket or all", bench);
+    cmd.AddValue("pattern", "buffer: inorder, reorder, loss or all", config.pattern);
+    cmd.AddValue("window", "buffer: window, in segments", config.window);
+    cmd.AddValue("every", "buffer: period of the reordered or lost segments", config.every);
+    cmd.AddValue("depth", "buffer: reordering delay, in segments", config.depth);
+    cmd.AddValue("acks", "buffer: number of ACKs to process", config.acks);
+    cmd.AddValue("simTime", "socket: simulated time, in seconds", simTime);
+    cmd.AddValue("reorder", "socket: use a ReorderQueue at the bottleneck", reorder);
+    cmd.AddValue("rack", "socket: enable RACK and D-SACK", rack);
+    cmd.AddValue("tlp", "socket: enable TLP", tlp);
+    cmd.Parse(argc, argv);
+
+    if (bench == "buffer" || bench == "all")
+    {
+        std::vector<std::string> patterns{config.pattern};
+        if (config.pattern == "all")
+        {
+            patterns = {"inorder", "reorder", "loss"};
+        }
+        for (const auto& pattern : patterns)
+        {
+            config.pattern = pattern;
+            RecoveryBench(config).Run();
+        }
+    }
+    if (bench == "socket" || bench == "all")
+    {
+        RunSocketBench(Seconds(simTime), reorder, rack, tlp);
+    }
+    return 0;
+}